@@ -19,13 +19,15 @@ class BenchmarkAnalyzer:
             'GAS': '#1f77b4',      # Azul
             'GAS-O1': '#ff7f0e',   # Naranja  
             'GAS-O2': '#2ca02c',   # Verde
+            'GAS-OPT': '#d62728',  # Rojo
         }
         
         # Marcadores
         self.algorithm_markers = {
             'GAS': 'o',
             'GAS-O1': 's', 
-            'GAS-O2': '^'
+            'GAS-O2': '^',
+            'GAS-OPT': 'D'
         }
     
     def load_data(self, filename="benchmark_results.csv"):
@@ -153,7 +155,7 @@ class BenchmarkAnalyzer:
                     label=algorithm, linewidth=2, markersize=6)
         
         ax3.set_xlabel(self._get_parameter_label(parameter_type))
-        ax3.set_ylabel('Memory Usage (MB)')
+        ax3.set_ylabel('Peak RSS Growth (MB)')
         ax3.set_title('(c) Memory Usage')
         ax3.legend()
         ax3.grid(True, alpha=0.3)
@@ -0,0 +1,50 @@
+import json
+import sys
+import argparse
+
+
+def load_configurations(path):
+    with open(path) as f:
+        summary = json.load(f)
+    return {(c['algorithm'], c['parameter_type'], c['parameter_value']): c
+            for c in summary['configurations']}, summary.get('harness', {})
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Comparar dos resúmenes *_summary.json de BenchmarkSuite y marcar regresiones')
+    parser.add_argument('base', help='Resumen del build de referencia')
+    parser.add_argument('candidate', help='Resumen del build nuevo')
+    parser.add_argument('--threshold', '-t', type=float, default=0.05,
+                        help='Aumento relativo de la mediana tolerado (default: 0.05)')
+    args = parser.parse_args()
+
+    base, base_harness = load_configurations(args.base)
+    candidate, candidate_harness = load_configurations(args.candidate)
+    if base_harness.get('seed') != candidate_harness.get('seed'):
+        print("Aviso: los resúmenes usan semillas distintas; las entradas no son las mismas")
+    if base_harness.get('jobs', 1) != candidate_harness.get('jobs', 1):
+        print("Aviso: los resúmenes corrieron con distinta cantidad de entradas en paralelo; "
+              "los tiempos no son comparables")
+
+    # Una regresión debe superar el umbral y además quedar fuera del ruido de la
+    # referencia: la mediana nueva por encima de su p95
+    regressions = 0
+    print(f"{'algorithm':<8} {'parameter':<10} {'value':>6} {'base_ms':>10} {'new_ms':>10} {'change':>8}")
+    for key in sorted(base.keys() & candidate.keys()):
+        old, new = base[key], candidate[key]
+        change = new['median_ms'] / old['median_ms'] - 1.0 if old['median_ms'] > 0 else 0.0
+        slower = change > args.threshold and new['median_ms'] > old['p95_ms']
+        regressions += slower
+        print(f"{key[0]:<8} {key[1]:<10} {key[2]:>6} {old['median_ms']:>10.3f} {new['median_ms']:>10.3f} "
+              f"{change:>+7.1%}{'  REGRESSION' if slower else ''}")
+
+    missing = base.keys() ^ candidate.keys()
+    if missing:
+        print(f"{len(missing)} configuraciones están en un solo resumen y no se comparan")
+    print(f"{regressions} regresiones")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,119 +1,1035 @@
 #include "additive_tree.hpp"
 #include "utils.hpp"
+#include "parallel.hpp"
+#include "slack_kernel.hpp"
+#include "trace.hpp"
 #include <iostream>
 #include <algorithm>
+#include <limits>
+#include <iterator>
+#include <cmath>
+#include <stdexcept>
 
-AdditiveTree::AdditiveTree(const std::vector<Request>& requests, int maxCapacity)
-    : allRequests(requests) {
-    root = new TreeNode(); 
-    build(maxCapacity);
+AdditiveTree::AdditiveTree(const RequestCatalog& catalog, int maxCapacity, const PlannerOptions& options,
+                           const ShareabilityGraph* pairs)
+    : catalog(catalog), vehicleContext{0, {0, 0}, maxCapacity, {}, {}}, options(options), pairs(pairs) { //árbol global: vehículo en el origen
+    this->options.numThreads = resolveThreadCount(options.numThreads);
+    build(catalog.allIndices(), maxCapacity);
 }
 
-AdditiveTree::AdditiveTree(const std::vector<Request>& requests, int maxCapacity, const Vehicle& v)
-    : allRequests(requests), vehicleContext(v) {
-    root = new TreeNode();
-    build(maxCapacity);
+AdditiveTree::AdditiveTree(const RequestCatalog& catalog, const std::vector<int>& candidates,
+                           int maxCapacity, const Vehicle& v, const PlannerOptions& options,
+                           const ShareabilityGraph* pairs)
+    : catalog(catalog), vehicleContext(v), options(options), pairs(pairs) {
+    this->options.numThreads = resolveThreadCount(options.numThreads);
+    build(candidates, maxCapacity);
 }
 
-AdditiveTree::~AdditiveTree() {
-    destroy(root);
+// Con optimizeRouteOrder cada hilo usa su propio RoutePlanner
+std::unique_ptr<RoutePlanner> AdditiveTree::makeRoutePlanner() const {
+    if (!options.optimizeRouteOrder) return nullptr;
+    return std::make_unique<RoutePlanner>(catalog, vehicleContext);
 }
 
-void AdditiveTree::destroy(TreeNode* node) {
-    for (auto child : node->children) {
-        destroy(child);
+// pending: candidatos (groupSize ids cada uno) hijos del padre parent de current, en
+// orden. Cada uno agrega un solo request a la ruta del padre, así que se evalúan todos
+// en lote a partir del resumen del padre y se agregan los factibles en ese orden; con
+// planner, el padre se carga una vez y cada hijo sólo prueba su último request.
+void AdditiveTree::appendFeasible(const TreeLevel& current, int parent, const std::vector<int>& pending,
+                                  TreeLevel& next, RoutePlanner* planner) const {
+    const int width = next.groupSize;
+    size_t count = pending.size() / width;
+    if (count == 0) return;
+    const double parentProfit = current.profit[parent];
+    const double noSummary = std::numeric_limits<double>::quiet_NaN();
+
+    thread_local std::vector<int> added;  // buffers reutilizados entre padres
+    thread_local std::vector<double> slack, endTime;
+    added.resize(count);
+    for (size_t g = 0; g < count; g++) added[g] = catalog.indexOf(pending[g * width + width - 1]);
+
+    if (planner) {
+        int prefix[MAX_GROUP_SIZE];
+        for (int k = 0; k < width - 1; k++) prefix[k] = catalog.indexOf(pending[k]);
+        if (!planner->assign(prefix, width - 1)) return;
+        [[maybe_unused]] size_t before = next.size();
+        for (size_t g = 0; g < count; g++) {
+            if (planner->probe(added[g])) {
+                appendNode(next, &pending[g * width], parentProfit + catalog.payment[added[g]], parent, noSummary, noSummary);
+            }
+        }
+        TRACE_COUNT("slack.checks", count);
+        TRACE_COUNT("slack.rejects", count - (next.size() - before));
+        return;
+    }
+
+    if (current.minSlack[parent] < 1.0) return;  // el padre ya viola la restricción
+
+    RouteState start;
+    start.time = current.routeTime[parent];
+    start.last = catalog.indexOf(pending[width - 2]);
+    slack.resize(count);
+    endTime.resize(count);
+    calculateMinSlackBatch(start, catalog, 1, added.data(), count, slack.data(), endTime.data());
+    TRACE_COUNT("slack.checks", count);
+
+    for (size_t g = 0; g < count; g++) {
+        if (slack[g] < 1.0) {
+            TRACE_COUNT("slack.rejects", 1);
+            continue;
+        }
+        double profit = parentProfit + catalog.payment[added[g]];  // aditivo
+        appendNode(next, &pending[g * width], profit, parent, endTime[g], std::min(current.minSlack[parent], slack[g]));
     }
-    delete node;
 }
 
-double AdditiveTree::calculateProfit(const std::set<int>& requestIds) {
-    double total = 0.0;
-    for (int id : requestIds) {
-        for (const auto& r : allRequests) {
-            if (r.id == id) {
-                total += r.payment;
-                break;
+
+
+namespace {
+
+// Nombre de la fase de construcción de cada nivel, para separar sus tiempos
+[[maybe_unused]] const char* levelPhase(int level) {
+    static const char* const NAMES[] = {"tree.level0", "tree.level1", "tree.level2", "tree.level3", "tree.level4",
+                                        "tree.level5", "tree.level6", "tree.level7", "tree.level8"};
+    return level < static_cast<int>(std::size(NAMES)) ? NAMES[level] : "tree.levelN";
+}
+
+// Primera posición de level cuyo grupo no es menor que ids
+size_t lowerBound(const TreeLevel& level, const int* ids) {
+    const int width = level.groupSize;
+    size_t lo = 0, hi = level.size();
+    while (lo < hi) {  // los niveles están en orden lexicográfico
+        size_t mid = (lo + hi) / 2;
+        const int* g = &level.members[mid * width];
+        if (std::lexicographical_compare(g, g + width, ids, ids + width)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Posición del grupo ids en level, o -1 si no está
+int findInLevel(const TreeLevel& level, const int* ids) {
+    size_t lo = lowerBound(level, ids);
+    const int width = level.groupSize;
+    if (lo < level.size() && std::equal(ids, ids + width, &level.members[lo * width])) return static_cast<int>(lo);
+    return -1;
+}
+
+// Reloj desde el que el grupo podría dejar de ser factible (minSlack + summaryClock, al
+// que se compara clock + 1). Un request del nivel 1 que ya no es factible no tiene hijos
+// y nunca vuelve a serlo: no vence.
+double expiry(const TreeLevel& level, size_t k) {
+    if (level.minSlack[k] < 1.0) return std::numeric_limits<double>::infinity();
+    return level.minSlack[k] + level.summaryClock[k];
+}
+
+// Copia el nodo from sobre to (sin padre: lo renumera quien mueve)
+void moveNode(TreeLevel& level, size_t from, size_t to) {
+    const size_t width = level.groupSize;
+    std::copy_n(&level.members[from * width], width, &level.members[to * width]);
+    level.profit[to] = level.profit[from];
+    level.firstChild[to] = level.firstChild[from];
+    level.childCount[to] = level.childCount[from];
+    level.routeTime[to] = level.routeTime[from];
+    level.minSlack[to] = level.minSlack[from];
+    level.summaryClock[to] = level.summaryClock[from];
+    level.maxProfit[to] = level.maxProfit[from];
+    level.slackHorizon[to] = level.slackHorizon[from];
+}
+
+// Corre los nodos [first, last) para que terminen en end (padre incluido)
+void moveBlock(TreeLevel& level, size_t first, size_t last, size_t end) {
+    const size_t width = level.groupSize;
+    auto shift = [&](auto& values, size_t w) {
+        std::copy_backward(values.begin() + first * w, values.begin() + last * w, values.begin() + end * w);
+    };
+    shift(level.members, width);
+    shift(level.profit, 1);
+    shift(level.parent, 1);
+    shift(level.firstChild, 1);
+    shift(level.childCount, 1);
+    shift(level.routeTime, 1);
+    shift(level.minSlack, 1);
+    shift(level.summaryClock, 1);
+    shift(level.maxProfit, 1);
+    shift(level.slackHorizon, 1);
+}
+
+void resizeLevel(TreeLevel& level, size_t size) {
+    level.members.resize(size * level.groupSize);
+    level.profit.resize(size);
+    level.parent.resize(size);
+    level.firstChild.resize(size);
+    level.childCount.resize(size);
+    level.routeTime.resize(size);
+    level.minSlack.resize(size);
+    level.summaryClock.resize(size);
+    level.maxProfit.resize(size);
+    level.slackHorizon.resize(size);
+}
+
+}
+
+void AdditiveTree::appendNode(TreeLevel& level, const int* ids, double profit, int parent,
+                              double routeTime, double minSlack) const {
+    level.members.insert(level.members.end(), ids, ids + level.groupSize);
+    level.profit.push_back(profit);
+    level.parent.push_back(parent);
+    level.firstChild.push_back(0);
+    level.childCount.push_back(0);
+    level.routeTime.push_back(routeTime);
+    level.minSlack.push_back(minSlack);
+    level.summaryClock.push_back(clock);
+    level.maxProfit.push_back(profit);  // las cotas de subárbol se completan al terminar de armar
+    level.slackHorizon.push_back(expiry(level, level.size() - 1));
+}
+
+bool AdditiveTree::containsGroup(const TreeLevel& level, const int* ids) const {
+    return findInLevel(level, ids) >= 0;
+}
+
+bool AdditiveTree::allSubsetsPresent(const TreeLevel& level, const int* candidate) const {
+    // los subconjuntos que omiten uno de los dos últimos ids son los padres del join
+    const int width = level.groupSize;
+    int subset[MAX_GROUP_SIZE];
+    for (int skip = 0; skip < width - 1; skip++) {
+        int n = 0;
+        for (int k = 0; k <= width; k++) {
+            if (k != skip) subset[n++] = candidate[k];
+        }
+        if (!containsGroup(level, subset)) return false;
+    }
+    return true;
+}
+
+void AdditiveTree::build(const std::vector<int>& candidates, int maxCapacity) {
+    TRACE_SCOPE("tree.build");
+    if (maxCapacity > MAX_GROUP_SIZE) throw std::invalid_argument("AdditiveTree: capacity above MAX_GROUP_SIZE");
+    maxGroupSize = maxCapacity;
+    levels.assign(1, TreeLevel());
+    appendNode(levels[0], nullptr, 0.0, -1, 0.0, 1e9);  // raíz
+
+    std::vector<int> sorted = candidates;
+    std::sort(sorted.begin(), sorted.end(),
+              [this](int a, int b) { return catalog.ids[a] < catalog.ids[b]; });
+
+    {
+        TRACE_SCOPE_DYNAMIC(levelPhase(1));
+        TreeLevel first;
+        first.groupSize = 1;
+        std::vector<double> slack(sorted.size()), endTime(sorted.size());
+        calculateMinSlackBatch(startRoute(catalog, vehicleContext), catalog, 1, sorted.data(), sorted.size(),
+                               slack.data(), endTime.data());
+        TRACE_COUNT("slack.checks", sorted.size());
+        for (size_t i = 0; i < sorted.size(); i++) {
+            appendNode(first, &catalog.ids[sorted[i]], catalog.payment[sorted[i]], 0, endTime[i], slack[i]);
+        }
+        levels[0].childCount[0] = static_cast<int>(first.size());
+        levels.push_back(std::move(first));
+    }
+    firstLevelIndex = sorted;
+
+    if (!pairs && !options.optimizeRouteOrder && maxCapacity >= 2 && !sorted.empty()) {  // la cota supone rutas secuenciales
+        pairWindows = std::make_unique<TimeWindowIndex>(catalog, sorted, options.spatialIndex);
+    }
+    if ((pairs || pairWindows) && maxCapacity >= 2 && !sorted.empty()) {
+        firstLevelPosition.assign(catalog.size(), -1);
+        for (size_t i = 0; i < sorted.size(); i++) firstLevelPosition[sorted[i]] = static_cast<int>(i);
+    }
+
+    for (int level = 2; level <= maxCapacity; level++) {
+        TRACE_SCOPE_DYNAMIC(levelPhase(level));
+        TreeLevel& current = levels.back();
+        TreeLevel next;
+        next.groupSize = level;
+
+        if (options.numThreads <= 1) {
+            expandRange(current, 0, current.size(), next);
+        } else {
+            // cada hilo expande bloques contiguos de padres en su propio buffer; al unir
+            // los buffers en orden de bloque el nivel queda idéntico al serial
+            size_t chunks = std::min(current.size(), static_cast<size_t>(options.numThreads) * 8);
+            size_t chunkSize = (current.size() + chunks - 1) / std::max<size_t>(chunks, 1);
+            std::vector<TreeLevel> partial(chunks);
+            parallelFor(chunks, options.numThreads, [&](size_t c) {
+                partial[c].groupSize = level;
+                size_t begin = c * chunkSize;
+                size_t end = std::min(current.size(), begin + chunkSize);
+                if (begin < end) expandRange(current, begin, end, partial[c]);
+            });
+            for (size_t c = 0; c < chunks; c++) {
+                size_t begin = c * chunkSize;
+                size_t end = std::min(current.size(), begin + chunkSize);
+                int offset = static_cast<int>(next.size());
+                for (size_t i = begin; i < end; i++) current.firstChild[i] += offset;
+                next.members.insert(next.members.end(), partial[c].members.begin(), partial[c].members.end());
+                next.profit.insert(next.profit.end(), partial[c].profit.begin(), partial[c].profit.end());
+                next.parent.insert(next.parent.end(), partial[c].parent.begin(), partial[c].parent.end());
+                next.firstChild.insert(next.firstChild.end(), partial[c].firstChild.begin(), partial[c].firstChild.end());
+                next.childCount.insert(next.childCount.end(), partial[c].childCount.begin(), partial[c].childCount.end());
+                next.routeTime.insert(next.routeTime.end(), partial[c].routeTime.begin(), partial[c].routeTime.end());
+                next.minSlack.insert(next.minSlack.end(), partial[c].minSlack.begin(), partial[c].minSlack.end());
+                next.summaryClock.insert(next.summaryClock.end(), partial[c].summaryClock.begin(), partial[c].summaryClock.end());
+                next.maxProfit.insert(next.maxProfit.end(), partial[c].maxProfit.begin(), partial[c].maxProfit.end());
+                next.slackHorizon.insert(next.slackHorizon.end(), partial[c].slackHorizon.begin(), partial[c].slackHorizon.end());
+                partial[c] = TreeLevel();  // liberar el buffer ya copiado
             }
         }
+
+        TRACE_COUNT("tree.nodes", next.size());
+        if (next.size() == 0) break;
+        levels.push_back(std::move(next));
+    }
+    updateSubtreeBounds();
+
+    firstLevelIndex = std::vector<int>();
+    firstLevelPosition = std::vector<int>();
+    pairWindows.reset();
+}
+
+// Apriori: el nivel k+1 se obtiene uniendo grupos del nivel k con el mismo prefijo
+// de k-1 ids; cada candidato se genera una sola vez y se descarta si algún
+// subconjunto de tamaño k no es factible (la factibilidad es cerrada hacia abajo).
+// Expande los padres [begin, end) de current; los hijos se agregan a next.
+void AdditiveTree::expandRange(TreeLevel& current, size_t begin, size_t end, TreeLevel& next) const {
+    if (current.groupSize == 1 && (pairs || pairWindows)) {
+        expandPairs(current, begin, end, next);
+        return;
+    }
+
+    const int width = current.groupSize;
+    const int level = width + 1;
+    int candidate[MAX_GROUP_SIZE];
+    std::vector<int> pending;
+    std::unique_ptr<RoutePlanner> planner = makeRoutePlanner();
+
+    for (size_t i = begin; i < end; i++) {
+        const int* a = &current.members[i * width];
+        current.firstChild[i] = static_cast<int>(next.size());
+        if (level > vehicleContext.capacity) {  // ningún grupo de este tamaño cabe
+            current.childCount[i] = 0;
+            continue;
+        }
+        pending.clear();
+        for (size_t j = i + 1; j < current.size(); j++) {
+            const int* b = &current.members[j * width];
+            if (!std::equal(a, a + width - 1, b)) break;  // fin del bloque con el mismo prefijo
+
+            std::copy(a, a + width, candidate);
+            candidate[width] = b[width - 1];
+            if (pairs) {  // descarte con bits antes de buscar los subconjuntos
+                int order[MAX_GROUP_SIZE];
+                for (int k = 0; k < width; k++) order[k] = catalog.indexOf(candidate[k]);
+                if (!pairs->canAppend(order, width, catalog.indexOf(candidate[width]))) continue;
+            }
+            if (!allSubsetsPresent(current, candidate)) continue;
+            pending.insert(pending.end(), candidate, candidate + level);
+        }
+        appendFeasible(current, static_cast<int>(i), pending, next, planner.get());
+        current.childCount[i] = static_cast<int>(next.size()) - current.firstChild[i];
+    }
+}
+
+// Nivel 2: si a va antes que b (ids crecientes), el vehículo deja a no antes de
+// releaseTime_a + viaje_a, así que b sólo es alcanzable si se cumple pairBoundHolds.
+// Con la matriz de la ronda se recorren directamente los sucesores de a; sin ella se
+// consulta el índice temporal desde el instante en que este vehículo deja a (el
+// resumen de ruta del nivel 1, que incluye su viaje hasta a) y se aplica la misma cota
+// por par desde ese instante. En ambos casos nunca se descarta un par factible.
+void AdditiveTree::expandPairs(TreeLevel& current, size_t begin, size_t end, TreeLevel& next) const {
+    std::vector<int> partners;
+    std::vector<int> pending;
+    std::vector<char> marked(current.size(), 0);
+    std::unique_ptr<RoutePlanner> planner = makeRoutePlanner();
+    for (size_t i = begin; i < end; i++) {
+        int a = firstLevelIndex[i];
+        current.firstChild[i] = static_cast<int>(next.size());
+
+        partners.clear();
+        auto addPartner = [&](int b) {
+            int j = firstLevelPosition[b];
+            if (j > static_cast<int>(i)) partners.push_back(j);
+        };
+        if (pairs) {
+            pairs->forEachFollower(a, addPartner);
+            if (options.stats) {
+                options.stats->pairChecks.fetch_add(current.size() - i - 1, std::memory_order_relaxed);
+                options.stats->pairRejects.fetch_add(current.size() - i - 1 - partners.size(), std::memory_order_relaxed);
+            }
+        } else if (current.minSlack[i] >= 1.0) {  // si no, appendFeasible descarta todos los hijos
+            pairWindows->forEachReachableAfter(current.routeTime[i], catalog.destX[a], catalog.destY[a], addPartner);
+        }
+        // el índice temporal no devuelve los pares en orden de id: con muchos, marcar y
+        // barrer el resto del nivel es más barato que ordenarlos
+        if (partners.size() * 16 < current.size() - i) {
+            std::sort(partners.begin(), partners.end());
+        } else {
+            for (int j : partners) marked[j] = 1;
+            partners.clear();
+            for (size_t j = i + 1; j < current.size(); j++) {
+                if (!marked[j]) continue;
+                partners.push_back(static_cast<int>(j));
+                marked[j] = 0;
+            }
+        }
+
+        pending.clear();
+        if (vehicleContext.capacity >= 2) {
+            for (int j : partners) {
+                pending.push_back(current.members[i]);
+                pending.push_back(current.members[j]);
+            }
+        }
+        appendFeasible(current, static_cast<int>(i), pending, next, planner.get());
+        current.childCount[i] = static_cast<int>(next.size()) - current.firstChild[i];
     }
-    return total;
 }
 
-bool AdditiveTree::isFeasible(const std::set<int>& requestIds, const Vehicle& v) {
-    if (requestIds.size() > (size_t)v.capacity) return false;
+// Busca el grupo bajando por el árbol: en cada nivel sólo entre los hijos del prefijo,
+// que están ordenados por su último id
+int AdditiveTree::findNode(int level, const int* ids) const {
+    int node = 0;
+    for (int depth = 1; depth <= level; depth++) {
+        const TreeLevel& up = levels[depth - 1];
+        const int* members = levels[depth].members.data();
+        int first = up.firstChild[node], last = first + up.childCount[node];
+        int end = last;
+        while (first < last) {
+            int mid = (first + last) / 2;
+            if (members[static_cast<size_t>(mid) * depth + depth - 1] < ids[depth - 1]) first = mid + 1;
+            else last = mid;
+        }
+        if (first == end || members[static_cast<size_t>(first) * depth + depth - 1] != ids[depth - 1]) return -1;
+        node = first;
+    }
+    return node;
+}
+
+// Índice del grupo en el nivel level contando primero los nodos existentes y después
+// los agregados (added[level]); -1 si no está en ninguno
+int AdditiveTree::findGroup(const std::vector<TreeLevel>& added, int level, const int* ids) const {
+    int existing = 0;
+    if (level < static_cast<int>(levels.size())) {
+        int k = findNode(level, ids);
+        if (k >= 0) return k;
+        existing = static_cast<int>(levels[level].size());
+    }
+    int k = findInLevel(added[level], ids);
+    return k >= 0 ? existing + k : -1;
+}
+
+// Join de Apriori restringido a los grupos nuevos: todo grupo (Q, a, b) que contiene un
+// request nuevo tiene un padre (Q, a) o un hermano (Q, b) nuevo, así que basta unir cada
+// nodo nuevo del nivel anterior con sus hermanos (los existentes son los hijos de Q en el
+// árbol). Devuelve los candidatos ordenados, con todos sus subconjuntos presentes.
+std::vector<int> AdditiveTree::joinNewGroups(const std::vector<TreeLevel>& added, int level) const {
+    const TreeLevel& fresh = added[level - 1];
+    const int width = level - 1;  // tamaño de los nodos que se unen
+    const bool oldLevel = width < static_cast<int>(levels.size());
+
+    std::vector<int> candidates;
+    std::vector<std::pair<int, int>> joined;  // últimos dos ids de cada candidato del bloque
+    int candidate[MAX_GROUP_SIZE], subset[MAX_GROUP_SIZE];
+    for (size_t begin = 0; begin < fresh.size();) {  // bloques con el mismo prefijo Q, en orden
+        const int* prefix = &fresh.members[begin * width];  // Q: los primeros width - 1 ids
+        size_t end = begin + 1;
+        while (end < fresh.size() && std::equal(prefix, prefix + width - 1, &fresh.members[end * width])) end++;
+
+        int first = 0, count = 0;  // hermanos existentes: hijos de Q en el árbol
+        if (oldLevel) {
+            int q = findNode(width - 1, prefix);
+            if (q >= 0) {
+                first = levels[width - 1].firstChild[q];
+                count = levels[width - 1].childCount[q];
+            }
+        }
+
+        joined.clear();
+        for (size_t s = begin; s < end; s++) {
+            int last = fresh.members[s * width + width - 1];
+            for (int t = first; t < first + count; t++) {
+                int other = levels[width].members[static_cast<size_t>(t) * width + width - 1];
+                joined.push_back({std::min(last, other), std::max(last, other)});
+            }
+            for (size_t t = s + 1; t < end; t++) joined.push_back({last, fresh.members[t * width + width - 1]});
+        }
+        std::sort(joined.begin(), joined.end());
+
+        std::copy(prefix, prefix + width - 1, candidate);
+        for (const auto& [a, b] : joined) {
+            candidate[level - 2] = a;
+            candidate[level - 1] = b;
+            bool complete = true;  // los que omiten uno de los dos últimos ids son los nodos unidos
+            for (int skip = 0; skip < level - 2 && complete; skip++) {
+                int n = 0;
+                for (int m = 0; m < level; m++) {
+                    if (m != skip) subset[n++] = candidate[m];
+                }
+                complete = findGroup(added, level - 1, subset) >= 0;
+            }
+            if (complete) candidates.insert(candidates.end(), candidate, candidate + level);
+        }
+        begin = end;
+    }
+    return candidates;
+}
+
+void AdditiveTree::insert(const std::vector<int>& indices) {
+    std::vector<int> fresh;
+    for (int r : indices) {
+        if (r < 0 || r >= static_cast<int>(catalog.size())) continue;
+        if (findNode(1, &catalog.ids[r]) >= 0) continue;  // ya está en el árbol
+        fresh.push_back(r);
+    }
+    std::sort(fresh.begin(), fresh.end(), [this](int a, int b) { return catalog.ids[a] < catalog.ids[b]; });
+    fresh.erase(std::unique(fresh.begin(), fresh.end()), fresh.end());
+    if (fresh.empty()) return;
+
+    std::vector<TreeLevel> added(maxGroupSize + 1);
+    for (int level = 0; level <= maxGroupSize; level++) added[level].groupSize = level;
+
+    std::vector<double> slack(fresh.size()), endTime(fresh.size());
+    calculateMinSlackBatch(startRoute(catalog, vehicleContext), catalog, 1, fresh.data(), fresh.size(),
+                           slack.data(), endTime.data());
+    for (size_t i = 0; i < fresh.size(); i++) {
+        appendNode(added[1], &catalog.ids[fresh[i]], catalog.payment[fresh[i]], 0, endTime[i], slack[i]);
+    }
+
+    std::unique_ptr<RoutePlanner> planner = makeRoutePlanner();
+    std::vector<int> pending;
+    for (int level = 2; level <= std::min(maxGroupSize, vehicleContext.capacity); level++) {
+        if (added[level - 1].size() == 0) break;  // todo grupo nuevo tiene un subconjunto nuevo
+        std::vector<int> candidates = joinNewGroups(added, level);
+        size_t count = candidates.size() / level;
+        int existing = static_cast<int>(level - 1 < static_cast<int>(levels.size()) ? levels[level - 1].size() : 0);
+
+        // candidatos agrupados por padre (prefijo de level - 1 ids), evaluados como en build
+        for (size_t g = 0; g < count;) {
+            const int* prefix = &candidates[g * level];
+            size_t end = g + 1;
+            while (end < count && std::equal(prefix, prefix + level - 1, &candidates[end * level])) end++;
+
+            int parent = findGroup(added, level - 1, prefix);
+            if (parent < existing) refreshSummary(level - 1, parent);  // los agregados ya están al día
+            const TreeLevel& owner = parent < existing ? levels[level - 1] : added[level - 1];
+            pending.assign(candidates.begin() + g * level, candidates.begin() + end * level);
+            size_t before = added[level].size();
+            appendFeasible(owner, parent < existing ? parent : parent - existing, pending, added[level], planner.get());
+            for (size_t k = before; k < added[level].size(); k++) added[level].parent[k] = parent;
+            g = end;
+        }
+    }
+
+    mergeNodes(added);
+}
+
+// Los grupos que contienen r son los subárboles de los nodos que terminan en r: el
+// prefijo de cada grupo hasta r es un nodo. Los que terminan en r en el nivel l + 1 son
+// (Q, q, r) con (Q, r) del nivel l y q < r un hermano suyo, así que se encuentran
+// recorriendo sólo hermanos e hijos, sin mirar el resto del árbol.
+void AdditiveTree::retire(const std::vector<int>& requestIds) {
+    std::vector<std::vector<char>> dead(levels.size());
+    std::vector<std::pair<int, int>> stack;  // (nivel, nodo) por marcar con su subárbol
+    std::vector<int> ending, nextEnding;
+    bool any = false;
 
-    std::vector<Request> group;
     for (int id : requestIds) {
-        for (const auto& r : allRequests) {
-            if (r.id == id) {
-                group.push_back(r);
-                break;
+        int pos = findNode(1, &id);
+        if (pos < 0) continue;
+        ending.assign(1, pos);
+        for (size_t l = 1; l < levels.size() && !ending.empty(); l++) {
+            nextEnding.clear();
+            const TreeLevel& level = levels[l];
+            for (int n : ending) {
+                stack.push_back({static_cast<int>(l), n});
+                if (l + 1 >= levels.size()) continue;
+                const TreeLevel& up = levels[l - 1];
+                const TreeLevel& down = levels[l + 1];
+                int width = static_cast<int>(l) + 1;
+                for (int m = up.firstChild[level.parent[n]]; m < n; m++) {  // hermanos con último id menor
+                    int first = level.firstChild[m], last = first + level.childCount[m];
+                    while (first < last) {  // hijos de m ordenados por último id
+                        int mid = (first + last) / 2;
+                        if (down.members[static_cast<size_t>(mid) * width + width - 1] < id) first = mid + 1;
+                        else last = mid;
+                    }
+                    if (first < level.firstChild[m] + level.childCount[m] &&
+                        down.members[static_cast<size_t>(first) * width + width - 1] == id) {
+                        nextEnding.push_back(first);
+                    }
+                }
             }
+            std::swap(ending, nextEnding);
         }
+
+        for (auto [l, n] : stack) markSubtree(l, n, dead);
+        any = any || !stack.empty();
+        stack.clear();
+    }
+    if (any) removeNodes(dead);
+}
+
+// Marca el nodo y todo su subárbol en dead (por nivel, se dimensiona al primer uso)
+void AdditiveTree::markSubtree(int level, int index, std::vector<std::vector<char>>& dead) const {
+    std::vector<std::pair<int, int>> stack = {{level, index}};
+    while (!stack.empty()) {
+        auto [l, n] = stack.back();
+        stack.pop_back();
+        if (dead[l].empty()) dead[l].assign(levels[l].size(), 0);
+        if (dead[l][n]) continue;  // ya marcado desde otro id retirado
+        dead[l][n] = 1;
+        const TreeLevel& node = levels[l];
+        for (int c = 0; c < node.childCount[n]; c++) stack.push_back({l + 1, node.firstChild[n] + c});
+    }
+}
+
+// Con tiempos más ajustados un grupo sólo puede dejar de ser factible, y si lo sigue
+// siendo también lo son sus subconjuntos, así que no hace falta join. Correr el reloj
+// elapsed segundos baja el slack de cada grupo a lo sumo elapsed: sólo se vuelven a
+// simular los nodos cuya cota minSlack + summaryClock quedó por debajo de clock + 1, y
+// se baja sólo a los subárboles cuyo slackHorizon lo está. El resto sigue factible con
+// su resumen viejo, que se pone al día al usarlo. El margen cubre el redondeo.
+void AdditiveTree::revalidate(int elapsed) {
+    TRACE_SCOPE("tree.revalidate");
+    if (elapsed < 0) throw std::invalid_argument("AdditiveTree::revalidate: elapsed must be non-negative");
+    clock += elapsed;
+    if (levels.size() < 2 || elapsed == 0) return;
+    if (options.optimizeRouteOrder) {  // sin resúmenes por nodo: se vuelve a probar todo
+        revalidateAll();
+        return;
     }
 
-    return calculateMinSlack(v, group) >= 1.0;
+    std::vector<std::vector<char>> dead(levels.size());
+    const double limit = clock + 1.0 + 1e-6;
+    if (levels[0].slackHorizon[0] < limit) revalidateSubtree(0, 0, limit, dead);
+    for (const auto& level : dead) {
+        if (!level.empty()) {
+            removeNodes(dead);
+            break;
+        }
+    }
 }
 
-void AdditiveTree::build(int maxCapacity) {
-    std::vector<TreeNode*> currentLevel;
-    for (const auto& r : allRequests) {
-        auto node = new TreeNode();
-        node->requestIds.insert(r.id);
-        node->profit = r.payment;
-        node->parent = root;
-        root->children.push_back(node);
-        currentLevel.push_back(node);
+// Vuelve a simular, en lote desde el resumen del nodo, los hijos en riesgo; marca en
+// dead los que dejaron de ser factibles (con su subárbol) y baja a los que siguen vivos
+// con algún descendiente en riesgo. Al volver, ajusta slackHorizon del nodo.
+void AdditiveTree::revalidateSubtree(int level, int index, double limit, std::vector<std::vector<char>>& dead) {
+    TreeLevel& node = levels[level];
+    if (level + 1 >= static_cast<int>(levels.size())) {
+        node.slackHorizon[index] = expiry(node, index);
+        return;
     }
+    TreeLevel& down = levels[level + 1];
+    const int width = level + 1;
+    const int first = node.firstChild[index], last = first + node.childCount[index];
 
-    for (int level = 2; level <= maxCapacity; level++) {
-        std::vector<TreeNode*> nextLevel;
-        for (size_t i = 0; i < currentLevel.size(); i++) {
-            for (size_t j = i + 1; j < currentLevel.size(); j++) {
-                std::set<int> combined;
-                std::set_union(currentLevel[i]->requestIds.begin(), currentLevel[i]->requestIds.end(),
-                               currentLevel[j]->requestIds.begin(), currentLevel[j]->requestIds.end(),
-                               std::inserter(combined, combined.begin()));
-                if (combined.size() == level && isFeasible(combined, vehicleContext)) {
-                    auto node = new TreeNode();
-                    node->requestIds = combined;
-                    node->profit = calculateProfit(combined);
-                    node->parent = currentLevel[i];
-                    currentLevel[i]->children.push_back(node);
-                    nextLevel.push_back(node);
+    thread_local std::vector<int> risky, added;
+    thread_local std::vector<double> slack, endTime;
+    risky.clear();
+    added.clear();
+    for (int c = first; c < last; c++) {
+        if (expiry(down, c) >= limit) continue;
+        risky.push_back(c);
+        added.push_back(catalog.indexOf(down.members[static_cast<size_t>(c) * width + width - 1]));
+    }
+    if (!risky.empty()) {
+        refreshSummary(level, index);
+        slack.resize(risky.size());
+        endTime.resize(risky.size());
+        calculateMinSlackBatch(routeAfter(level, index), catalog, 1, added.data(), added.size(),
+                               slack.data(), endTime.data());
+        TRACE_COUNT("slack.checks", risky.size());
+        for (size_t g = 0; g < risky.size(); g++) {  // antes de bajar: la recursión reutiliza los buffers
+            int c = risky[g];
+            if (slack[g] < 1.0 && level > 0) {
+                TRACE_COUNT("slack.rejects", 1);
+                markSubtree(level + 1, c, dead);
+                continue;
+            }
+            down.routeTime[c] = endTime[g];
+            down.minSlack[c] = std::min(node.minSlack[index], slack[g]);
+            down.summaryClock[c] = clock;
+            if (slack[g] < 1.0) {  // el nivel 1 tiene todos los requests: sólo pierde los hijos
+                for (int d = 0; d < down.childCount[c]; d++) markSubtree(level + 2, down.firstChild[c] + d, dead);
+            }
+        }
+    }
+
+    double horizon = expiry(node, index);
+    for (int c = first; c < last; c++) {
+        if (!dead[level + 1].empty() && dead[level + 1][c]) continue;
+        if (down.slackHorizon[c] < limit) revalidateSubtree(level + 1, c, limit, dead);
+        horizon = std::min(horizon, down.slackHorizon[c]);
+    }
+    node.slackHorizon[index] = horizon;
+}
+
+// Con optimizeRouteOrder: los hijos actuales de cada nodo son los únicos candidatos y
+// cada nivel se vuelve a armar con appendFeasible sobre ellos, como en build pero sin join.
+void AdditiveTree::revalidateAll() {
+
+    TreeLevel& first = levels[1];
+    std::vector<int> indices(first.size());
+    for (size_t k = 0; k < first.size(); k++) indices[k] = catalog.indexOf(first.members[k]);
+    calculateMinSlackBatch(startRoute(catalog, vehicleContext), catalog, 1, indices.data(), indices.size(),
+                           first.minSlack.data(), first.routeTime.data());
+
+    std::unique_ptr<RoutePlanner> planner = makeRoutePlanner();
+    std::vector<int> parentMap(first.size());  // índice viejo -> nuevo del nivel anterior (-1 = quitado)
+    for (size_t k = 0; k < first.size(); k++) parentMap[k] = static_cast<int>(k);
+    std::vector<int> pending, map;
+    for (size_t l = 2; l < levels.size(); l++) {
+        const TreeLevel& up = levels[l - 1];
+        const TreeLevel& old = levels[l];
+        const size_t width = l;
+        TreeLevel next;
+        next.groupSize = static_cast<int>(l);
+        map.assign(old.size(), -1);
+
+        for (size_t begin = 0; begin < old.size();) {  // hijos de un mismo padre, contiguos
+            size_t end = begin + 1;
+            while (end < old.size() && old.parent[end] == old.parent[begin]) end++;
+            int parent = parentMap[old.parent[begin]];
+            if (parent >= 0) {
+                pending.assign(old.members.begin() + begin * width, old.members.begin() + end * width);
+                size_t before = next.size();
+                appendFeasible(up, parent, pending, next, planner.get());
+                for (size_t k = begin, n = before; n < next.size(); k++) {  // los que quedan, en orden
+                    if (next.members[n * width + width - 1] != old.members[k * width + width - 1]) continue;
+                    map[k] = static_cast<int>(n++);
                 }
             }
+            begin = end;
+        }
+        levels[l] = std::move(next);
+        parentMap.swap(map);
+    }
+    updateChildRanges();
+    updateSubtreeBounds();
+}
+
+// Compacta cada nivel en su lugar sin los nodos muertos y renumera los padres. Cada
+// nivel se recorre desde su primer nodo que cambia (muerto o con el padre renumerado);
+// el prefijo queda igual. Los rangos de hijos se rehacen desde ahí y las cotas de
+// subárbol sólo en los ancestros de lo quitado.
+void AdditiveTree::removeNodes(const std::vector<std::vector<char>>& dead) {
+    std::vector<std::vector<int>> touched(levels.size());  // nodos cuyas cotas cambian (índices nuevos)
+    size_t stable = levels[0].size();  // el nivel anterior conserva los índices menores que stable
+    std::vector<int> map, nextMap;     // índice nuevo de cada nodo viejo desde stable (-1 = quitado)
+    for (size_t l = 1; l < levels.size(); l++) {
+        TreeLevel& level = levels[l];
+        const size_t n = level.size();
+        const bool anyDead = l < dead.size() && !dead[l].empty();
+        size_t start = std::lower_bound(level.parent.begin(), level.parent.end(), static_cast<int>(stable)) -
+                       level.parent.begin();  // los padres no decrecen
+        if (anyDead) start = std::min<size_t>(start, std::find(dead[l].begin(), dead[l].end(), 1) - dead[l].begin());
+
+        nextMap.assign(n - start, -1);
+        size_t w = start;
+        for (size_t k = start; k < n; k++) {
+            int p = level.parent[k];
+            int parent = p < static_cast<int>(stable) ? p : map[p - stable];
+            if (anyDead && dead[l][k]) {
+                std::vector<int>& up = touched[l - 1];
+                if (parent >= 0 && (up.empty() || up.back() != parent)) up.push_back(parent);
+                continue;
+            }
+            nextMap[k - start] = static_cast<int>(w);
+            if (w != k) moveNode(level, k, w);
+            level.parent[w] = parent;
+            w++;
         }
-        currentLevel = nextLevel;
+        resizeLevel(level, w);
+        updateChildRanges(l - 1, stable, start);
+        stable = start;
+        map.swap(nextMap);
     }
+    while (levels.size() > 2 && levels.back().size() == 0) levels.pop_back();
+    updateSubtreeBounds(touched);
 }
 
-std::vector<TreeNode*> AdditiveTree::getAllNodes() {
-    std::vector<TreeNode*> nodes;
-    std::vector<TreeNode*> stack = {root};
+// Intercala en cada nivel sus nodos agregados (ordenados) de atrás hacia adelante, en
+// el mismo arreglo; los padres de added vienen con el índice combinado de findGroup.
+// Como en removeNodes, cada nivel sólo se toca desde su primer nodo que cambia.
+void AdditiveTree::mergeNodes(const std::vector<TreeLevel>& added) {
+    for (size_t l = levels.size(); l < added.size() && added[l].size() > 0; l++) {
+        levels.emplace_back();
+        levels.back().groupSize = static_cast<int>(l);
+    }
+
+    std::vector<std::vector<int>> touched(levels.size());
+    size_t stable = levels[0].size();
+    std::vector<int> map, nextMap;  // índice combinado (existentes y después agregados) desde stable -> nuevo
+    for (size_t l = 1; l < levels.size(); l++) {
+        TreeLevel& level = levels[l];
+        const TreeLevel& extra = added[l];
+        const size_t width = l;
+        const size_t n = level.size(), m = extra.size();
+        auto less = [&](const int* a, const int* b) { return std::lexicographical_compare(a, a + width, b, b + width); };
+
+        size_t start = std::lower_bound(level.parent.begin(), level.parent.end(), static_cast<int>(stable)) -
+                       level.parent.begin();
+        if (m > 0) start = std::min(start, lowerBound(level, &extra.members[0]));
+        nextMap.resize(n + m - start);
+        for (size_t k = start; k < n; k++) nextMap[k - start] = static_cast<int>(k);
+        resizeLevel(level, n + m);
+
+        size_t i = n, j = m, w = n + m;
+        while (j > 0) {
+            const int* b = &extra.members[(j - 1) * width];
+
+            // los existentes mayores que b son [pos, i): búsqueda exponencial hacia atrás
+            size_t lo = i, step = 1;
+            while (lo > 0 && less(b, &level.members[(lo - 1) * width])) {
+                size_t next = lo > step ? lo - step : 0;
+                if (!less(b, &level.members[next * width])) {
+                    size_t hi = lo - 1;  // level[hi] > b, level[next] < b
+                    lo = next + 1;
+                    while (lo < hi) {
+                        size_t mid = (lo + hi) / 2;
+                        if (less(b, &level.members[mid * width])) hi = mid;
+                        else lo = mid + 1;
+                    }
+                    break;
+                }
+                lo = next;
+                step *= 2;
+            }
+
+            size_t run = i - lo;  // se corren en bloque
+            if (run > 0) {
+                moveBlock(level, lo, i, w);
+                for (size_t k = lo; k < i; k++) nextMap[k - start] = static_cast<int>(k + (w - i));
+                w -= run;
+                i = lo;
+            }
+
+            --j;
+            --w;
+            std::copy_n(b, width, &level.members[w * width]);
+            level.profit[w] = extra.profit[j];
+            level.parent[w] = extra.parent[j];
+            level.firstChild[w] = 0;
+            level.childCount[w] = 0;
+            level.routeTime[w] = extra.routeTime[j];
+            level.minSlack[w] = extra.minSlack[j];
+            level.summaryClock[w] = extra.summaryClock[j];
+            level.maxProfit[w] = std::numeric_limits<double>::quiet_NaN();  // nuevo: sus cotas siempre suben
+            nextMap[n + j - start] = static_cast<int>(w);
+            touched[l].push_back(static_cast<int>(w));
+        }
+        std::reverse(touched[l].begin(), touched[l].end());
+        for (size_t k = start; k < n + m; k++) {
+            int p = level.parent[k];
+            level.parent[k] = p < static_cast<int>(stable) ? p : map[p - stable];
+        }
+        updateChildRanges(l - 1, stable, start);
+        stable = start;
+        map.swap(nextMap);
+    }
+    updateSubtreeBounds(touched);
+}
+
+// Rangos de hijos de levels[level] después de reescribir levels[level + 1] desde start.
+// Los padres cuyos hijos terminaban antes de start (todos con índice menor que stable)
+// no cambian; del resto se vuelven a contar.
+void AdditiveTree::updateChildRanges(size_t level, size_t stable, size_t start) {
+    TreeLevel& up = levels[level];
+    size_t lo = 0, hi = std::min(stable, up.size());
+    while (lo < hi) {  // los finales de rango no decrecen
+        size_t mid = (lo + hi) / 2;
+        if (static_cast<size_t>(up.firstChild[mid] + up.childCount[mid]) < start) lo = mid + 1;
+        else hi = mid;
+    }
+    int c = lo == 0 ? 0 : up.firstChild[lo - 1] + up.childCount[lo - 1];
+    const bool below = level + 1 < levels.size();
+    for (size_t p = lo; p < up.size(); p++) {
+        up.firstChild[p] = c;
+        if (below) {
+            const std::vector<int>& parent = levels[level + 1].parent;
+            while (c < static_cast<int>(parent.size()) && parent[c] == static_cast<int>(p)) c++;
+        }
+        up.childCount[p] = c - up.firstChild[p];
+    }
+}
+
+// Los hijos de cada padre son contiguos en el orden lexicográfico del nivel siguiente
+void AdditiveTree::updateChildRanges() {
+    while (levels.size() > 2 && levels.back().size() == 0) levels.pop_back();
+    for (size_t l = 0; l < levels.size(); l++) {
+        TreeLevel& level = levels[l];
+        std::fill(level.firstChild.begin(), level.firstChild.end(), 0);
+        std::fill(level.childCount.begin(), level.childCount.end(), 0);
+        if (l + 1 == levels.size()) continue;
+        for (int p : levels[l + 1].parent) level.childCount[p]++;
+        int offset = 0;
+        for (size_t k = 0; k < level.size(); k++) {
+            level.firstChild[k] = offset;
+            offset += level.childCount[k];
+        }
+    }
+}
+
+// De abajo hacia arriba: cada nodo toma el máximo profit y el menor horizonte de slack
+// entre los suyos y los de sus hijos
+void AdditiveTree::updateSubtreeBounds() {
+    for (size_t l = levels.size(); l-- > 0;) {
+        TreeLevel& level = levels[l];
+        level.maxProfit = level.profit;
+        level.slackHorizon.resize(level.size());
+        for (size_t k = 0; k < level.size(); k++) level.slackHorizon[k] = expiry(level, k);
+        if (l + 1 == levels.size()) continue;
+        const TreeLevel& below = levels[l + 1];
+        for (size_t k = 0; k < level.size(); k++) {
+            for (int c = level.firstChild[k]; c < level.firstChild[k] + level.childCount[k]; c++) {
+                level.maxProfit[k] = std::max(level.maxProfit[k], below.maxProfit[c]);
+                level.slackHorizon[k] = std::min(level.slackHorizon[k], below.slackHorizon[c]);
+            }
+        }
+    }
+}
+
+// Sólo los nodos de touched (índices por nivel, ordenados y sin repetir) y los
+// ancestros cuyas cotas cambian
+void AdditiveTree::updateSubtreeBounds(std::vector<std::vector<int>>& touched) {
+    touched.resize(levels.size());
+    for (size_t l = levels.size(); l-- > 0;) {
+        std::vector<int>& nodes = touched[l];
+        TreeLevel& level = levels[l];
+        const size_t given = l > 0 ? touched[l - 1].size() : 0;  // los padres agregados abajo van después
+        for (int k : nodes) {
+            const double oldBest = level.maxProfit[k], oldHorizon = level.slackHorizon[k];
+            double best = level.profit[k];
+            double horizon = expiry(level, k);
+            if (l + 1 < levels.size()) {
+                const TreeLevel& below = levels[l + 1];
+                for (int c = level.firstChild[k]; c < level.firstChild[k] + level.childCount[k]; c++) {
+                    best = std::max(best, below.maxProfit[c]);
+                    horizon = std::min(horizon, below.slackHorizon[c]);
+                }
+            }
+            level.maxProfit[k] = best;
+            level.slackHorizon[k] = horizon;
+            if (l == 0 || (best == oldBest && horizon == oldHorizon)) continue;
+            std::vector<int>& up = touched[l - 1];
+            if (up.size() == given || up.back() != level.parent[k]) up.push_back(level.parent[k]);
+        }
+        if (l > 0) {  // dos tramos ordenados
+            std::vector<int>& up = touched[l - 1];
+            std::inplace_merge(up.begin(), up.begin() + given, up.end());
+            up.erase(std::unique(up.begin(), up.end()), up.end());
+        }
+    }
+}
+
+// Estado de la ruta al terminar el grupo del nodo (la raíz: el vehículo del árbol)
+RouteState AdditiveTree::routeAfter(int level, int index) const {
+    if (level == 0) return startRoute(catalog, vehicleContext);
+    const TreeLevel& l = levels[level];
+    RouteState state;
+    state.time = l.routeTime[index];
+    state.last = catalog.indexOf(l.members[static_cast<size_t>(index) * level + level - 1]);
+    return state;
+}
+
+// Pone al día el resumen de ruta del nodo (y el de sus ancestros) con el reloj actual,
+// con las mismas operaciones que appendFeasible
+void AdditiveTree::refreshSummary(int level, int index) {
+    if (level == 0 || options.optimizeRouteOrder) return;
+    TreeLevel& l = levels[level];
+    if (l.summaryClock[index] == clock) return;
+    int parent = l.parent[index];
+    refreshSummary(level - 1, parent);
+    int r = catalog.indexOf(l.members[static_cast<size_t>(index) * level + level - 1]);
+    double slack, endTime;
+    calculateMinSlackBatch(routeAfter(level - 1, parent), catalog, 1, &r, 1, &slack, &endTime);
+    l.routeTime[index] = endTime;
+    l.minSlack[index] = std::min(levels[level - 1].minSlack[parent], slack);
+    l.summaryClock[index] = clock;
+}
+
+// (routeTime, minSlack) del nodo con el reloj actual, sin guardarlo
+std::pair<double, double> AdditiveTree::currentSummary(int level, int index) const {
+    const TreeLevel& l = levels[level];
+    if (level == 0 || options.optimizeRouteOrder || l.summaryClock[index] == clock) {
+        return {l.routeTime[index], l.minSlack[index]};
+    }
+    int parent = l.parent[index];
+    auto [time, parentSlack] = currentSummary(level - 1, parent);
+    RouteState start = routeAfter(level - 1, parent);
+    start.time = time;
+    int r = catalog.indexOf(l.members[static_cast<size_t>(index) * level + level - 1]);
+    double slack, endTime;
+    calculateMinSlackBatch(start, catalog, 1, &r, 1, &slack, &endTime);
+    return {endTime, std::min(parentSlack, slack)};
+}
+
+bool AdditiveTree::sameNodes(const AdditiveTree& other) const {
+    auto sameValues = [](const std::vector<double>& a, const std::vector<double>& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                          [](double x, double y) { return x == y || (std::isnan(x) && std::isnan(y)); });
+    };
+    if (levels.size() != other.levels.size()) return false;
+    for (size_t l = 0; l < levels.size(); l++) {
+        const TreeLevel& a = levels[l];
+        const TreeLevel& b = other.levels[l];
+        if (a.members != b.members || a.parent != b.parent || a.firstChild != b.firstChild ||
+            a.childCount != b.childCount || !sameValues(a.profit, b.profit) ||
+            !sameValues(a.maxProfit, b.maxProfit)) {
+            return false;
+        }
+        for (size_t k = 0; k < a.size(); k++) {  // los resúmenes, con el reloj de cada árbol
+            auto [timeA, slackA] = currentSummary(static_cast<int>(l), static_cast<int>(k));
+            auto [timeB, slackB] = other.currentSummary(static_cast<int>(l), static_cast<int>(k));
+            if (!sameValues({timeA, slackA}, {timeB, slackB})) return false;
+        }
+    }
+    return true;
+}
+
+TreeNode AdditiveTree::node(int level, int index) const {
+    const TreeLevel& l = levels[level];
+    const int* ids = l.members.data() + static_cast<size_t>(index) * l.groupSize;
+    return {{ids, ids + l.groupSize}, l.profit[index], level, index};
+}
+
+size_t AdditiveTree::nodeCount() const {
+    size_t total = 0;
+    for (const auto& l : levels) total += l.size();
+    return total;
+}
+
+std::vector<TreeNode> AdditiveTree::getAllNodes() const {
+    TRACE_SCOPE("tree.flatten");
+    std::vector<TreeNode> nodes;
+    nodes.reserve(nodeCount());
+    std::vector<std::pair<int, int>> stack = {{0, 0}};
     while (!stack.empty()) {
-        TreeNode* node = stack.back();
+        auto [level, index] = stack.back();
         stack.pop_back();
-        nodes.push_back(node);
-        for (auto* child : node->children) {
-            stack.push_back(child);
+        nodes.push_back(node(level, index));
+        if (level + 1 >= static_cast<int>(levels.size())) continue;
+        const TreeLevel& l = levels[level];
+        for (int c = 0; c < l.childCount[index]; c++) {
+            stack.push_back({level + 1, l.firstChild[index] + c});
         }
     }
     return nodes;
 }
 
-TreeNode* AdditiveTree::findMostProfitableGroupForVehicle(const Vehicle& v) {
-    TreeNode* best = nullptr;
+TreeNode AdditiveTree::findMostProfitableGroupForVehicle(const Vehicle& v) const {
+    TreeNode best = node(0, 0);
     double maxProfit = -1;
 
-    for (TreeNode* node : getAllNodes()) {
-        if (node->requestIds.size() <= static_cast<size_t>(v.capacity)) {
-            if (node->profit > maxProfit) {
-                maxProfit = node->profit;
-                best = node;
-            }
+    // en empate gana el primero del recorrido, así que basta con superar a maxProfit
+    forEachNodeAbove([&] { return maxProfit; }, [&](const TreeNode& n) {
+        if (n.level > v.capacity) return false;
+        if (n.profit > maxProfit) {
+            maxProfit = n.profit;
+            best = n;
         }
-    }
+        return n.level < v.capacity;
+    });
 
     return best;
 }
@@ -2,36 +2,167 @@
 #define ADDITIVE_TREE_HPP
 
 #include <vector>
-#include <set>
+#include <memory>
+#include <cstddef>
+#include <utility>
 #include "request.hpp"
 #include "vehicle.hpp"
+#include "request_catalog.hpp"
+#include "planner_options.hpp"
+#include "time_window_index.hpp"
+#include "shareability_graph.hpp"
+#include "route_planner.hpp"
+#include "utils.hpp"
 
+constexpr int MAX_GROUP_SIZE = MAX_VEHICLE_CAPACITY;  // tamaño máximo de grupo soportado por el árbol
+static_assert(MAX_GROUP_SIZE <= RoutePlanner::MAX_REQUESTS, "los grupos deben caber en RoutePlanner");
+
+// Vista de solo lectura sobre los ids (ordenados) de un grupo
+struct GroupIds {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+// Handle ligero a un nodo del árbol; los datos viven en TreeLevel
 struct TreeNode {
-    std::set<int> requestIds;  // IDs de los requests en este nodo
-    double profit = 0.0; // suma de pagos de los requests
-    std::vector<TreeNode*> children;  // hijos
-    TreeNode* parent = nullptr;  // nodo padre
+    GroupIds requestIds;  // IDs de los requests en este nodo
+    double profit = 0.0;  // suma de pagos de los requests
+    int level = 0;        // tamaño del grupo (0 = raíz)
+    int index = 0;        // posición dentro del nivel
+};
+
+// Todos los nodos de un nivel en arreglos contiguos (SoA)
+struct TreeLevel {
+    int groupSize = 0;
+    std::vector<int> members;     // groupSize ids por nodo, ordenados
+    std::vector<double> profit;
+    std::vector<int> parent;      // índice del padre en el nivel anterior
+    std::vector<int> firstChild;  // los hijos forman un rango contiguo en el nivel siguiente
+    std::vector<int> childCount;
+
+    // Resumen de la ruta secuencial del grupo para el vehículo del árbol: tiempo al dejar
+    // el último request y slack mínimo (la posición final es el destino del último id).
+    // Un hijo agrega un request al final, así que se evalúa en O(1) desde su padre.
+    // Con optimizeRouteOrder sólo lo tienen la raíz y el nivel 1 (el resto guarda NaN).
+    // Vale para el reloj del árbol en summaryClock; revalidate no rehace los que siguen
+    // siendo factibles, se ponen al día cuando hacen falta (refreshSummary).
+    std::vector<double> routeTime;
+    std::vector<double> minSlack;
+    std::vector<int> summaryClock;
+
+    // Mayor profit del subárbol de cada nodo (él incluido): cota para podar búsquedas
+    std::vector<double> maxProfit;
+    // Menor minSlack + summaryClock del subárbol: el slack de un grupo baja a lo sumo lo
+    // que corre el reloj, así que ninguno del subárbol puede volverse infactible antes
+    // de que clock + 1 llegue a esta cota
+    std::vector<double> slackHorizon;
+
+    size_t size() const { return profit.size(); }
 };
 
 class AdditiveTree {
 public:
-    TreeNode* root;
-    std::vector<Request> allRequests;
+    std::vector<TreeLevel> levels;  // levels[0] = raíz, levels[k] = grupos de tamaño k
+    const RequestCatalog& catalog;
     Vehicle vehicleContext;
 
-    AdditiveTree(const std::vector<Request>& requests, int maxCapacity);
-    AdditiveTree(const std::vector<Request>& requests, int maxCapacity, const Vehicle& v); //para cada vehículo
-    ~AdditiveTree();
+    // options.numThreads > 1 construye cada nivel en paralelo; el resultado es idéntico al serial.
+    // pairs (opcional) es la matriz de pares de la ronda, compartida entre árboles.
+    AdditiveTree(const RequestCatalog& catalog, int maxCapacity, const PlannerOptions& options = {},
+                 const ShareabilityGraph* pairs = nullptr);
+    AdditiveTree(const RequestCatalog& catalog, const std::vector<int>& candidates,
+                 int maxCapacity, const Vehicle& v, const PlannerOptions& options = {},
+                 const ShareabilityGraph* pairs = nullptr); //para cada vehículo, índices del catálogo
+
+    TreeNode node(int level, int index) const;
+    size_t nodeCount() const;
+    std::vector<TreeNode> getAllNodes() const;
+    TreeNode findMostProfitableGroupForVehicle(const Vehicle& v) const;
+
+    // Recorre los nodos en el orden de getAllNodes sin materializarlos y salta los
+    // subárboles cuyo mayor profit no supera bound(), que se consulta en cada nodo y
+    // puede subir durante el recorrido. visit(node) devuelve false para no bajar a los
+    // hijos del nodo. Devuelve la cantidad de subárboles podados por la cota.
+    template <typename Bound, typename Visit>
+    size_t forEachNodeAbove(Bound&& bound, Visit&& visit) const;
 
-    std::vector<TreeNode*> getAllNodes();  
-    TreeNode* findMostProfitableGroupForVehicle(const Vehicle& v);
+    // Mantenimiento incremental entre rondas: el árbol queda idéntico (orden y resúmenes
+    // incluidos) al que se construiría desde cero con el nuevo conjunto de requests.
+    // insert sólo genera y simula los grupos que contienen algún request nuevo (índices
+    // del catálogo, que puede haber crecido con RequestCatalog::add); retire ubica los
+    // grupos de los ids dados recorriendo el árbol como índice invertido. Después cada
+    // nivel se compacta o intercala en su lugar, sin volver a evaluar rutas.
+    void insert(const std::vector<int>& indices);
+    void retire(const std::vector<int>& requestIds);
+    // Tras correr los tiempos del catálogo elapsed >= 0 segundos (RequestCatalog::shiftTimes):
+    // quita los grupos que dejaron de ser factibles, sin join. Sólo vuelve a simular los
+    // subárboles cuyo slackHorizon alcanzó el reloj; con optimizeRouteOrder, todos.
+    void revalidate(int elapsed);
+
+    // Mismos niveles, en el mismo orden, con los mismos profits y resúmenes de ruta:
+    // para comprobar que el mantenimiento incremental coincide con reconstruir
+    bool sameNodes(const AdditiveTree& other) const;
 
 private:
-    void build(int maxCapacity);
-    void destroy(TreeNode* node);
-    double calculateProfit(const std::set<int>& requestIds);
-    //bool isFeasible(const std::set<int>& requestIds);
-    bool isFeasible(const std::set<int>& requestIds, const Vehicle& v);
+    void build(const std::vector<int>& candidates, int maxCapacity);
+    void expandRange(TreeLevel& current, size_t begin, size_t end, TreeLevel& next) const;
+    void expandPairs(TreeLevel& current, size_t begin, size_t end, TreeLevel& next) const;
+    void appendNode(TreeLevel& level, const int* ids, double profit, int parent,
+                    double routeTime, double minSlack) const;
+    bool containsGroup(const TreeLevel& level, const int* ids) const;
+    bool allSubsetsPresent(const TreeLevel& level, const int* candidate) const;
+    void appendFeasible(const TreeLevel& current, int parent, const std::vector<int>& pending,
+                        TreeLevel& next, RoutePlanner* planner) const;
+    std::unique_ptr<RoutePlanner> makeRoutePlanner() const;
+    int findNode(int level, const int* ids) const;
+    int findGroup(const std::vector<TreeLevel>& added, int level, const int* ids) const;
+    std::vector<int> joinNewGroups(const std::vector<TreeLevel>& added, int level) const;
+    RouteState routeAfter(int level, int index) const;
+    void refreshSummary(int level, int index);
+    std::pair<double, double> currentSummary(int level, int index) const;
+    void markSubtree(int level, int index, std::vector<std::vector<char>>& dead) const;
+    void revalidateSubtree(int level, int index, double limit, std::vector<std::vector<char>>& dead);
+    void revalidateAll();
+    void removeNodes(const std::vector<std::vector<char>>& dead);
+    void mergeNodes(const std::vector<TreeLevel>& added);
+    void updateChildRanges();
+    void updateChildRanges(size_t level, size_t stable, size_t start);
+    void updateSubtreeBounds();
+    void updateSubtreeBounds(std::vector<std::vector<int>>& touched);
+
+    PlannerOptions options;
+    const ShareabilityGraph* pairs;
+    // Sólo durante build (índices del catálogo, que después puede compactarse)
+    std::vector<int> firstLevelIndex;     // índice del catálogo de cada nodo del nivel 1
+    std::vector<int> firstLevelPosition;  // índice del catálogo -> posición en el nivel 1
+    std::unique_ptr<TimeWindowIndex> pairWindows;  // nivel 1 por tiempo, para filtrar pares sin matriz
+    int maxGroupSize = 0;
+    int clock = 0;  // segundos corridos con revalidate desde la construcción
 };
 
+template <typename Bound, typename Visit>
+size_t AdditiveTree::forEachNodeAbove(Bound&& bound, Visit&& visit) const {
+    size_t pruned = 0;
+    std::vector<std::pair<int, int>> stack = {{0, 0}};
+    while (!stack.empty()) {
+        auto [level, index] = stack.back();
+        stack.pop_back();
+        const TreeLevel& l = levels[level];
+        if (l.maxProfit[index] <= bound()) {
+            pruned++;
+            continue;
+        }
+        if (!visit(node(level, index)) || level + 1 >= static_cast<int>(levels.size())) continue;
+        for (int c = 0; c < l.childCount[index]; c++) {
+            stack.push_back({level + 1, l.firstChild[index] + c});
+        }
+    }
+    return pruned;
+}
+
 #endif
@@ -7,11 +7,21 @@
 #include <chrono>
 #include <iomanip>
 #include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
 #include "request.hpp"
 #include "vehicle.hpp"
+#include "request_catalog.hpp"
 #include "planner_gas.hpp"
 #include "planner_gaso1.hpp"
 #include "planner_gaso2.hpp"
+#include "planner_optimal.hpp"
+#include "planner_options.hpp"
+#include "additive_tree.hpp"
+#include "online_dispatcher.hpp"
+#include "memory_tracker.hpp"
+#include "trace.hpp"
+#include "parallel.hpp"
 #include "utils.hpp"
 
 struct BenchmarkResult {
@@ -19,44 +29,139 @@ struct BenchmarkResult {
     int parameter_value;
     double total_revenue;
     double execution_time_ms;
-    double memory_usage_mb;
+    double memory_usage_mb;               // crecimiento del pico de RSS (-1 si no se pudo medir)
     int requests_served;
     int total_requests;
     int total_vehicles;
     std::string parameter_type;
+    unsigned long long pair_checks = 0;   // grupos evaluados contra la matriz de pares
+    unsigned long long pair_rejects = 0;  // descartados sin simular la ruta
+    unsigned long long search_nodes = 0;     // GAS-OPT: nodos del branch-and-bound
+    unsigned long long search_timeouts = 0;  // GAS-OPT: 1 si la búsqueda se cortó por tiempo
+    unsigned long long allocations = 0;   // llamadas a operator new del planner
+    double allocated_mb = 0.0;            // total asignado, aunque se haya liberado
+    double peak_live_mb = 0.0;            // pico de memoria viva en el heap
+    unsigned seed = 0;                    // semilla de la entrada y del orden de GAS-O2
+    int repetition = 0;                   // corrida medida sobre la misma entrada
+};
+
+// Cómo se repite cada configuración: la iteración i genera la entrada con seed + i,
+// cada planner corre warmup_runs veces sin medir y después repetitions veces.
+// Con jobs > 1 varias entradas corren a la vez en el planificador de tareas; cada
+// corrida sigue midiendo su propio tiempo, pero comparte núcleos y cachés, y la
+// memoria y las fases (que son del proceso) no se miden.
+struct HarnessOptions {
+    unsigned seed = 42;
+    int warmup_runs = 1;
+    int repetitions = 1;
+    int pinned_cpu = -1;          // sólo se informa en el resumen; lo fija main_benchmark
+    int jobs = 1;                 // entradas en paralelo (1 = corridas aisladas)
+    bool pinned_workers = false;  // ídem, TaskScheduler::configure
+    bool verify_tree = false;     // despacho con GAS-O1: comparar el árbol incremental con uno reconstruido
+};
+
+// Una entrada generada; se corre con todos los planners
+struct BenchmarkInput {
+    std::vector<Request> requests;
+    std::vector<Vehicle> vehicles;
+    int parameter_value;
+    std::string parameter_type;
+    unsigned seed;
+};
+
+// Tiempo total de una fase o valor de un contador (trace.hpp) en una corrida
+struct PhaseResult {
+    std::string algorithm;
+    std::string parameter_type;
+    int parameter_value;
+    std::string name;
+    bool counter;       // contador: value es la suma; fase: calls y total_ms
+    uint64_t value;     // llamadas de la fase o valor del contador
+    double total_ms;
+};
+
+// Una corrida del despacho en línea con un planner y una longitud de ronda
+struct OnlineResult {
+    std::string algorithm;
+    int epoch_length;
+    DispatchSummary summary;
+};
+
+// Árbol global entre rondas: ms promedio por ronda de reconstruirlo contra ponerlo al
+// día (retire + revalidate + insert) cuando cambia churn_percent de los pendientes
+struct ChurnResult {
+    int requests;
+    int churn_percent;
+    size_t nodes;        // al final de la última ronda
+    double rebuild_ms;
+    double incremental_ms;
+    bool identical;      // los dos árboles coincidieron en todas las rondas
 };
 
 class BenchmarkSuite {
 private:
     std::vector<BenchmarkResult> results;
+    std::vector<OnlineResult> online_results;
+    std::vector<ChurnResult> churn_results;
+    std::vector<PhaseResult> phase_results;  // vacío si se compiló sin ENABLE_TRACING
     std::string output_directory;
+    PlannerOptions planner_options;
+    HarnessOptions harness;
+    TravelOracle travel_oracle;  // métrica de los catálogos generados
     
-    // Medición de tiempo
-    std::chrono::high_resolution_clock::time_point start_time;
-    
-    void startTimer() {
-        start_time = std::chrono::high_resolution_clock::now();
-    }
-    
-    double stopTimer() {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    // Medición de tiempo (por corrida: las entradas pueden correr en paralelo)
+    using Clock = std::chrono::high_resolution_clock;
+
+    static double elapsedMs(Clock::time_point start_time) {
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_time);
         return duration.count() / 1000.0; // Convertir a milisegundos
     }
     
-    double estimateMemoryUsage(int num_requests, int num_vehicles, int capacity) {
-        double request_memory = num_requests * sizeof(Request) / (1024.0 * 1024.0);
-        double vehicle_memory = num_vehicles * sizeof(Vehicle) / (1024.0 * 1024.0);
-        double tree_memory = 0.0;
-        
-        if (capacity <= 3) {
-            tree_memory = (num_requests + num_requests * (num_requests - 1) / 2) * 64.0 / (1024.0 * 1024.0);
+    static constexpr std::pair<const char*, PlannerFunction> PLANNERS[] = {
+        {"GAS", planRoutesGAS}, {"GAS-O1", planRoutesGASO1}, {"GAS-O2", planRoutesGASO2},
+        {"GAS-OPT", planRoutesOptimal}};
+
+    // seed fija el orden de GAS-O2 igual que en measureAlgorithms (sin 0: no reproducible)
+    DispatchOptions dispatchOptions(int epoch_length, PlannerFunction planner, unsigned seed) const {
+        DispatchOptions options;
+        options.epochLength = epoch_length;
+        options.planner = planner;
+        if (planner == static_cast<PlannerFunction>(planRoutesGASO1)) {
+            options.treePlanner = planRoutesGASO1;  // mismo resultado, árbol mantenido entre rondas
+            options.verifyTree = harness.verify_tree;
         }
-        
-        return request_memory + vehicle_memory + tree_memory;
+        options.plannerOptions = planner_options;
+        options.plannerOptions.shuffleSeed = seed;
+        options.travel = travel_oracle;
+        return options;
     }
-    
-    int countServedRequests(const std::vector<Vehicle>& vehicles) {
+
+    void collectPhases(const std::string& algorithm, const std::string& parameter_type, int parameter_value) {
+        if (!trace::compiledIn()) return;
+        for (const auto& phase : trace::phases()) {
+            phase_results.push_back({algorithm, parameter_type, parameter_value, phase.name, false,
+                                     phase.calls, phase.totalMs});
+        }
+        for (const auto& counter : trace::counters()) {
+            phase_results.push_back({algorithm, parameter_type, parameter_value, counter.name, true,
+                                     counter.value, 0.0});
+        }
+    }
+
+    // Los export fallan con una excepción en vez de anunciar un archivo que no se escribió
+    std::ofstream openOutput(const std::string& filename) const {
+        std::ofstream file(output_directory + "/" + filename);
+        if (!file) throw std::runtime_error("cannot open " + output_directory + "/" + filename);
+        return file;
+    }
+
+    void closeOutput(std::ofstream& file, const std::string& filename, const char* what) const {
+        file.close();
+        if (!file) throw std::runtime_error("cannot write " + output_directory + "/" + filename);
+        std::cout << what << " exported to: " << output_directory + "/" + filename << std::endl;
+    }
+
+    static int countServedRequests(const std::vector<Vehicle>& vehicles) {
         int count = 0;
         for (const auto& v : vehicles) {
             count += v.assignedRequestIds.size();
@@ -64,17 +169,13 @@ private:
         return count;
     }
     
-    double calculateTotalRevenue(const std::vector<Request>& requests, 
+    static double calculateTotalRevenue(const RequestCatalog& catalog, 
                                const std::vector<Vehicle>& vehicles) {
         double total = 0.0;
         for (const auto& v : vehicles) {
             for (int req_id : v.assignedRequestIds) {
-                for (const auto& r : requests) {
-                    if (r.id == req_id) {
-                        total += r.payment;
-                        break;
-                    }
-                }
+                int index = catalog.indexOf(req_id);
+                if (index >= 0) total += catalog.payment[index];
             }
         }
         return total;
@@ -84,6 +185,19 @@ public:
     BenchmarkSuite(const std::string& output_dir = "benchmark_results") 
         : output_directory(output_dir) {}
     
+    void setPlannerOptions(const PlannerOptions& options) {
+        planner_options = options;
+        planner_options.stats = nullptr;  // cada corrida usa los suyos
+    }
+
+    void setTravelOracle(const TravelOracle& oracle) {
+        travel_oracle = oracle;
+    }
+
+    void setHarnessOptions(const HarnessOptions& options) {
+        harness = options;
+    }
+    
     // Benchmark 1: Requests (m)
     void benchmarkRequestVariation(const std::vector<int>& request_counts, 
                                   int fixed_vehicles = 20, 
@@ -92,22 +206,25 @@ public:
                                   int iterations = 5) {
         
         std::cout << "=== Benchmark: Request Variation ===" << std::endl;
+        std::vector<BenchmarkInput> inputs;
         
         for (int num_requests : request_counts) {
             std::cout << "Testing with " << num_requests << " requests..." << std::endl;
             
             for (int iter = 0; iter < iterations; iter++) {
-                auto requests = generateRandomRequests(num_requests, 50, 100, 10);
-                auto vehicles = generateVehicles(fixed_vehicles, fixed_capacity, 10);
+                unsigned seed = harness.seed + iter;
+                auto requests = generateRandomRequests(num_requests, 50, 100, 10, seed);
+                auto vehicles = generateVehicles(fixed_vehicles, fixed_capacity, 10, seed);
                 
                 // Ajustar deadlines
                 for (auto& r : requests) {
                     r.deadline = r.releaseTime + fixed_deadline;
                 }
                 
-                runAlgorithmSuite(requests, vehicles, num_requests, "requests");
+                queueInput(inputs, {requests, vehicles, num_requests, "requests", seed});
             }
         }
+        runInputs(inputs);
     }
     
     // Benchmark 2: Vehiculos (n) 
@@ -118,22 +235,25 @@ public:
                                   int iterations = 5) {
         
         std::cout << "=== Benchmark: Vehicle Variation ===" << std::endl;
+        std::vector<BenchmarkInput> inputs;
         
         for (int num_vehicles : vehicle_counts) {
             std::cout << "Testing with " << num_vehicles << " vehicles..." << std::endl;
             
             for (int iter = 0; iter < iterations; iter++) {
-                auto requests = generateRandomRequests(fixed_requests, 50, 100, 10);
-                auto vehicles = generateVehicles(num_vehicles, fixed_capacity, 10);
+                unsigned seed = harness.seed + iter;
+                auto requests = generateRandomRequests(fixed_requests, 50, 100, 10, seed);
+                auto vehicles = generateVehicles(num_vehicles, fixed_capacity, 10, seed);
                 
                 // Ajustar deadlines
                 for (auto& r : requests) {
                     r.deadline = r.releaseTime + fixed_deadline;
                 }
                 
-                runAlgorithmSuite(requests, vehicles, num_vehicles, "vehicles");
+                queueInput(inputs, {requests, vehicles, num_vehicles, "vehicles", seed});
             }
         }
+        runInputs(inputs);
     }
     
     // Benchmark 3: Capacidad
@@ -144,22 +264,25 @@ public:
                                    int iterations = 5) {
         
         std::cout << "=== Benchmark: Capacity Variation ===" << std::endl;
+        std::vector<BenchmarkInput> inputs;
         
         for (int capacity : capacities) {
             std::cout << "Testing with capacity " << capacity << "..." << std::endl;
             
             for (int iter = 0; iter < iterations; iter++) {
-                auto requests = generateRandomRequests(fixed_requests, 50, 100, 10);
-                auto vehicles = generateVehicles(fixed_vehicles, capacity, 10);
+                unsigned seed = harness.seed + iter;
+                auto requests = generateRandomRequests(fixed_requests, 50, 100, 10, seed);
+                auto vehicles = generateVehicles(fixed_vehicles, capacity, 10, seed);
                 
                 // Ajustar deadlines
                 for (auto& r : requests) {
                     r.deadline = r.releaseTime + fixed_deadline;
                 }
                 
-                runAlgorithmSuite(requests, vehicles, capacity, "capacity");
+                queueInput(inputs, {requests, vehicles, capacity, "capacity", seed});
             }
         }
+        runInputs(inputs);
     }
     
     // Benchmark 4: Deadline
@@ -170,103 +293,287 @@ public:
                                    int iterations = 5) {
         
         std::cout << "=== Benchmark: Deadline Variation ===" << std::endl;
+        std::vector<BenchmarkInput> inputs;
         
         for (int deadline : deadlines) {
             std::cout << "Testing with deadline " << deadline << "..." << std::endl;
             
             for (int iter = 0; iter < iterations; iter++) {
-                auto requests = generateRandomRequests(fixed_requests, 50, 100, 10);
-                auto vehicles = generateVehicles(fixed_vehicles, fixed_capacity, 10);
+                unsigned seed = harness.seed + iter;
+                auto requests = generateRandomRequests(fixed_requests, 50, 100, 10, seed);
+                auto vehicles = generateVehicles(fixed_vehicles, fixed_capacity, 10, seed);
                 
                 // Ajustar deadlines
                 for (auto& r : requests) {
                     r.deadline = r.releaseTime + deadline;
                 }
                 
-                runAlgorithmSuite(requests, vehicles, deadline, "deadline");
+                queueInput(inputs, {requests, vehicles, deadline, "deadline", seed});
             }
         }
+        runInputs(inputs);
     }
     
-    void runAlgorithmSuite(std::vector<Request> requests, 
-                          std::vector<Vehicle> vehicles,
+    // En modo aislado la entrada corre en el momento; con jobs > 1 se junta para runInputs
+    void queueInput(std::vector<BenchmarkInput>& inputs, BenchmarkInput input) {
+        if (harness.jobs <= 1) {
+            runAlgorithmSuite(input.requests, input.vehicles, input.parameter_value, input.parameter_type, input.seed);
+        } else {
+            inputs.push_back(std::move(input));
+        }
+    }
+
+    // Reparte las entradas juntadas entre los hilos del planificador (cada una corre
+    // todos sus planners en secuencia); los resultados quedan en el orden de las
+    // entradas, igual que en modo aislado
+    void runInputs(const std::vector<BenchmarkInput>& inputs) {
+        std::vector<std::vector<BenchmarkResult>> measured(inputs.size());
+        parallelFor(inputs.size(), harness.jobs, [&](size_t k) {
+            const BenchmarkInput& in = inputs[k];
+            measured[k] = measureAlgorithms(in.requests, in.vehicles, in.parameter_value, in.parameter_type,
+                                            in.seed, false);
+        });
+        for (auto& batch : measured) results.insert(results.end(), batch.begin(), batch.end());
+    }
+
+    void runAlgorithmSuite(const std::vector<Request>& requests, 
+                          const std::vector<Vehicle>& vehicles,
                           int parameter_value,
-                          const std::string& parameter_type) {
+                          const std::string& parameter_type,
+                          unsigned seed = 0) {
+        std::vector<BenchmarkResult> batch =
+            measureAlgorithms(requests, vehicles, parameter_value, parameter_type, seed, true);
+        results.insert(results.end(), batch.begin(), batch.end());
+    }
+
+    // isolated: la corrida es la única del proceso, así que también se miden la memoria
+    // (contadores globales) y las fases de trace
+    std::vector<BenchmarkResult> measureAlgorithms(const std::vector<Request>& requests,
+                                                   const std::vector<Vehicle>& vehicles,
+                                                   int parameter_value,
+                                                   const std::string& parameter_type,
+                                                   unsigned seed, bool isolated) {
+        std::vector<BenchmarkResult> batch;
+        RequestCatalog catalog(requests, travel_oracle);
+        PlannerStats run_stats;
+        PlannerOptions options = planner_options;
+        options.shuffleSeed = seed;
+        options.stats = &run_stats;
         
-        // Test GAS
-        {
-            auto req_copy = requests;
-            auto veh_copy = vehicles;
-            startTimer();
-            planRoutesGAS(req_copy, veh_copy);
-            double time_ms = stopTimer();
-            
-            BenchmarkResult result;
-            result.algorithm = "GAS";
-            result.parameter_value = parameter_value;
-            result.parameter_type = parameter_type;
-            result.total_revenue = calculateTotalRevenue(requests, veh_copy);
-            result.execution_time_ms = time_ms;
-            result.memory_usage_mb = estimateMemoryUsage(requests.size(), vehicles.size(), vehicles[0].capacity);
-            result.requests_served = countServedRequests(veh_copy);
-            result.total_requests = requests.size();
-            result.total_vehicles = vehicles.size();
-            
-            results.push_back(result);
+        for (const auto& [name, planner] : PLANNERS) {
+            for (int w = 0; w < harness.warmup_runs; w++) {  // cachés y asignador en régimen; no se registra
+                auto veh_copy = vehicles;
+                planner(catalog, veh_copy, options);
+            }
+
+            for (int rep = 0; rep < harness.repetitions; rep++) {
+                auto veh_copy = vehicles;
+                run_stats.reset();
+                MemoryProbe probe;
+                if (isolated) {
+                    trace::resetTotals();
+                    probe.start();
+                }
+                auto start_time = Clock::now();
+                {
+                    TRACE_SCOPE_DYNAMIC(name);
+                    planner(catalog, veh_copy, options);
+                }
+                double time_ms = elapsedMs(start_time);
+                MemoryUsage memory;  // sin medir: peakRssMb = -1
+                if (isolated) {
+                    memory = probe.stop();
+                    collectPhases(name, parameter_type, parameter_value);
+                }
+                
+                BenchmarkResult result;
+                result.algorithm = name;
+                result.parameter_value = parameter_value;
+                result.parameter_type = parameter_type;
+                result.total_revenue = calculateTotalRevenue(catalog, veh_copy);
+                result.execution_time_ms = time_ms;
+                result.memory_usage_mb = memory.peakRssMb;
+                result.allocations = memory.allocations;
+                result.allocated_mb = memory.allocatedMb;
+                result.peak_live_mb = memory.peakLiveMb;
+                result.requests_served = countServedRequests(veh_copy);
+                result.total_requests = requests.size();
+                result.total_vehicles = vehicles.size();
+                result.pair_checks = run_stats.pairChecks;
+                result.pair_rejects = run_stats.pairRejects;
+                result.search_nodes = run_stats.searchNodes;
+                result.search_timeouts = run_stats.searchTimeouts;
+                result.seed = seed;
+                result.repetition = rep;
+                
+                batch.push_back(result);
+            }
         }
-        
-        // Test GAS-O1
-        {
-            auto req_copy = requests;
-            auto veh_copy = vehicles;
-            startTimer();
-            planRoutesGASO1(req_copy, veh_copy);
-            double time_ms = stopTimer();
-            
-            BenchmarkResult result;
-            result.algorithm = "GAS-O1";
-            result.parameter_value = parameter_value;
-            result.parameter_type = parameter_type;
-            result.total_revenue = calculateTotalRevenue(requests, veh_copy);
-            result.execution_time_ms = time_ms;
-            result.memory_usage_mb = estimateMemoryUsage(requests.size(), vehicles.size(), vehicles[0].capacity);
-            result.requests_served = countServedRequests(veh_copy);
-            result.total_requests = requests.size();
-            result.total_vehicles = vehicles.size();
-            
-            results.push_back(result);
+        return batch;
+    }
+    
+    // Benchmark 5: despacho en línea. Los requests llegan a lo largo de stream_span
+    // segundos y se planifican por rondas; para cada longitud de ronda se corre cada
+    // planner sobre el mismo stream. Es una sola iteración: el stream, la flota y GAS-O2 usan harness.seed
+    void benchmarkOnlineDispatch(const std::vector<int>& epoch_lengths,
+                                 int num_requests = 300,
+                                 int num_vehicles = 20,
+                                 int capacity = 3,
+                                 int deadline_window = 300,
+                                 int stream_span = 1200) {
+
+        std::cout << "=== Benchmark: Online Dispatch ===" << std::endl;
+
+        auto stream = generateRandomRequests(num_requests, 50, 2 * stream_span, 10, harness.seed);
+        for (auto& r : stream) {
+            r.deadline = r.releaseTime + deadline_window;
         }
-        
-        // Test GAS-O2
-        {
-            auto req_copy = requests;
-            auto veh_copy = vehicles;
-            startTimer();
-            planRoutesGASO2(req_copy, veh_copy);
-            double time_ms = stopTimer();
-            
-            BenchmarkResult result;
-            result.algorithm = "GAS-O2";
-            result.parameter_value = parameter_value;
-            result.parameter_type = parameter_type;
-            result.total_revenue = calculateTotalRevenue(requests, veh_copy);
-            result.execution_time_ms = time_ms;
-            result.memory_usage_mb = estimateMemoryUsage(requests.size(), vehicles.size(), vehicles[0].capacity);
-            result.requests_served = countServedRequests(veh_copy);
-            result.total_requests = requests.size();
-            result.total_vehicles = vehicles.size();
-            
-            results.push_back(result);
+        auto fleet = generateVehicles(num_vehicles, capacity, 10, harness.seed);
+
+        for (int epoch_length : epoch_lengths) {
+            std::cout << "Testing with epoch length " << epoch_length << "..." << std::endl;
+
+            for (const auto& [name, planner] : PLANNERS) {
+                OnlineDispatcher dispatcher(fleet, dispatchOptions(epoch_length, planner, harness.seed));
+                online_results.push_back({name, epoch_length, dispatcher.run(stream)});
+            }
         }
     }
-    
+
+    // Benchmark 5 sobre un día grabado (.rspc ordenado por releaseTime, ver ConvertInputs);
+    // el archivo se lee por rondas a medida que avanza el despacho
+    void benchmarkOnlineReplay(const std::vector<int>& epoch_lengths,
+                               const std::string& request_file,
+                               const std::vector<Vehicle>& fleet) {
+
+        std::cout << "=== Benchmark: Online Replay of " << request_file << " ===" << std::endl;
+
+        for (int epoch_length : epoch_lengths) {
+            std::cout << "Testing with epoch length " << epoch_length << "..." << std::endl;
+
+            for (const auto& [name, planner] : PLANNERS) {
+                RequestStream stream(request_file);
+                OnlineDispatcher dispatcher(fleet, dispatchOptions(epoch_length, planner, harness.seed));
+                online_results.push_back({name, epoch_length, dispatcher.run(stream)});
+            }
+        }
+    }
+
+    // Benchmark 6: mantenimiento del árbol global. Cada ronda avanza epoch_length
+    // segundos, quita churn_percent de los pendientes y agrega otros tantos del stream
+    void benchmarkTreeChurn(const std::vector<int>& churn_percents,
+                            int num_requests = 200,
+                            int capacity = 3,
+                            int deadline_window = 300,
+                            int rounds = 10,
+                            int epoch_length = 30) {
+
+        std::cout << "=== Benchmark: Tree Churn ===" << std::endl;
+
+        for (int churn : churn_percents) {
+            std::cout << "Testing with churn " << churn << "%..." << std::endl;
+
+            int replaced = std::max(1, num_requests * churn / 100);
+            auto stream = generateRandomRequests(num_requests + rounds * replaced, 50,
+                                                 2 * rounds * epoch_length, 10, harness.seed);
+            for (auto& r : stream) {
+                r.deadline = r.releaseTime + deadline_window;
+            }
+
+            RequestCatalog catalog({}, travel_oracle);
+            size_t next = 0;
+            for (; next < static_cast<size_t>(num_requests); next++) catalog.add(stream[next]);
+            AdditiveTree tree(catalog, capacity, planner_options);
+
+            std::mt19937 rng(harness.seed);
+            ChurnResult result{num_requests, churn, 0, 0.0, 0.0, true};
+            for (int round = 1; round <= rounds; round++) {
+                std::vector<char> keep(catalog.size(), 1);
+                std::vector<int> retired;
+                while (static_cast<int>(retired.size()) < std::min<int>(replaced, catalog.size())) {
+                    size_t r = rng() % catalog.size();
+                    if (!keep[r]) continue;
+                    keep[r] = 0;
+                    retired.push_back(catalog.ids[r]);
+                }
+                catalog.compact(keep);
+                catalog.shiftTimes(epoch_length);
+                std::vector<int> added;
+                for (int k = 0; k < replaced && next < stream.size(); k++, next++) {
+                    Request r = stream[next];
+                    r.releaseTime -= round * epoch_length;
+                    r.deadline -= round * epoch_length;
+                    added.push_back(catalog.add(r));
+                }
+
+                auto start_time = Clock::now();
+                tree.retire(retired);
+                tree.revalidate(epoch_length);
+                tree.insert(added);
+                result.incremental_ms += elapsedMs(start_time) / rounds;
+
+                start_time = Clock::now();
+                AdditiveTree rebuilt(catalog, capacity, planner_options);
+                result.rebuild_ms += elapsedMs(start_time) / rounds;
+                result.identical = result.identical && tree.sameNodes(rebuilt);
+            }
+            result.nodes = tree.nodeCount();
+            churn_results.push_back(result);
+        }
+    }
+
+    void exportChurnResults(const std::string& filename = "tree_churn_results.csv") {
+        system(("mkdir -p " + output_directory).c_str());
+        std::ofstream file = openOutput(filename);
+
+        file << "requests,churn_percent,nodes,rebuild_ms,incremental_ms,identical\n";
+        for (const auto& result : churn_results) {
+            file << result.requests << ","
+                 << result.churn_percent << ","
+                 << result.nodes << ","
+                 << std::fixed << std::setprecision(3) << result.rebuild_ms << ","
+                 << std::fixed << std::setprecision(3) << result.incremental_ms << ","
+                 << (result.identical ? 1 : 0) << "\n";
+        }
+
+        closeOutput(file, filename, "Results");
+    }
+
+    void exportOnlineResults(const std::string& filename = "online_results.csv") {
+        system(("mkdir -p " + output_directory).c_str());
+        std::ofstream file = openOutput(filename);
+
+        file << "algorithm,epoch_length,epochs,total_requests,requests_served,requests_expired,"
+             << "total_revenue,mean_wait_s,latency_p50_ms,latency_p95_ms,latency_p99_ms,latency_max_ms\n";
+
+        for (const auto& result : online_results) {
+            const DispatchSummary& s = result.summary;
+            file << result.algorithm << ","
+                 << result.epoch_length << ","
+                 << s.epochs.size() << ","
+                 << s.totalRequests << ","
+                 << s.served << ","
+                 << s.expired << ","
+                 << std::fixed << std::setprecision(2) << s.revenue << ","
+                 << std::fixed << std::setprecision(2) << s.meanWait << ","
+                 << std::fixed << std::setprecision(3) << s.latencyP50 << ","
+                 << std::fixed << std::setprecision(3) << s.latencyP95 << ","
+                 << std::fixed << std::setprecision(3) << s.latencyP99 << ","
+                 << std::fixed << std::setprecision(3) << s.latencyMax << "\n";
+        }
+
+        closeOutput(file, filename, "Results");
+    }
+
     // Exportar resultados a CSV
     void exportResults(const std::string& filename = "benchmark_results.csv") {
-        std::ofstream file(output_directory + "/" + filename);
+        system(("mkdir -p " + output_directory).c_str());
+        std::ofstream file = openOutput(filename);
         
         file << "algorithm,parameter_type,parameter_value,total_revenue,execution_time_ms,"
              << "memory_usage_mb,requests_served,total_requests,total_vehicles,"
-             << "service_rate,revenue_per_request\n";
+             << "service_rate,revenue_per_request,pair_checks,pair_rejects,"
+             << "allocations,allocated_mb,peak_live_mb,seed,repetition,search_nodes,search_timeouts\n";
         
         for (const auto& result : results) {
             double service_rate = static_cast<double>(result.requests_served) / result.total_requests;
@@ -282,11 +589,95 @@ public:
                  << result.total_requests << ","
                  << result.total_vehicles << ","
                  << std::fixed << std::setprecision(4) << service_rate << ","
-                 << std::fixed << std::setprecision(2) << revenue_per_request << "\n";
+                 << std::fixed << std::setprecision(2) << revenue_per_request << ","
+                 << result.pair_checks << ","
+                 << result.pair_rejects << ","
+                 << result.allocations << ","
+                 << std::fixed << std::setprecision(3) << result.allocated_mb << ","
+                 << std::fixed << std::setprecision(3) << result.peak_live_mb << ","
+                 << result.seed << ","
+                 << result.repetition << ","
+                 << result.search_nodes << ","
+                 << result.search_timeouts << "\n";
         }
         
-        file.close();
-        std::cout << "Results exported to: " << output_directory + "/" + filename << std::endl;
+        closeOutput(file, filename, "Results");
+
+        if (!phase_results.empty()) exportPhaseResults("phases_" + filename);
+        exportSummary(filename.substr(0, filename.rfind('.')) + "_summary.json");
+    }
+
+    // Estadísticas del tiempo de ejecución por (algoritmo, parámetro, valor) sobre todas
+    // las semillas y repeticiones, en JSON para comparar dos builds
+    void exportSummary(const std::string& filename) {
+        struct Configuration {
+            const BenchmarkResult* first;
+            std::vector<double> times;
+            double revenue = 0.0, served = 0.0;
+        };
+        std::vector<Configuration> configurations;  // en el orden en que se corrieron
+        for (const auto& result : results) {
+            auto it = std::find_if(configurations.begin(), configurations.end(), [&](const Configuration& c) {
+                return c.first->algorithm == result.algorithm && c.first->parameter_type == result.parameter_type &&
+                       c.first->parameter_value == result.parameter_value;
+            });
+            if (it == configurations.end()) {
+                configurations.push_back({&result, {}});
+                it = configurations.end() - 1;
+            }
+            it->times.push_back(result.execution_time_ms);
+            it->revenue += result.total_revenue;
+            it->served += result.requests_served;
+        }
+
+        std::ofstream file = openOutput(filename);
+        file << std::fixed << std::setprecision(4);
+        file << "{\n  \"harness\": {\"seed\": " << harness.seed
+             << ", \"warmup_runs\": " << harness.warmup_runs
+             << ", \"repetitions\": " << harness.repetitions
+             << ", \"pinned_cpu\": " << harness.pinned_cpu
+             << ", \"jobs\": " << harness.jobs
+             << ", \"pinned_workers\": " << (harness.pinned_workers ? "true" : "false")
+             << ", \"planner_threads\": " << planner_options.numThreads << "},\n";
+        file << "  \"configurations\": [";
+        for (size_t i = 0; i < configurations.size(); i++) {
+            const Configuration& c = configurations[i];
+            double samples = static_cast<double>(c.times.size());
+            file << (i ? ",\n" : "\n")
+                 << "    {\"algorithm\": \"" << c.first->algorithm << "\""
+                 << ", \"parameter_type\": \"" << c.first->parameter_type << "\""
+                 << ", \"parameter_value\": " << c.first->parameter_value
+                 << ", \"samples\": " << c.times.size()
+                 << ", \"median_ms\": " << percentile(c.times, 0.5)
+                 << ", \"p95_ms\": " << percentile(c.times, 0.95)
+                 << ", \"mean_ms\": " << mean(c.times)
+                 << ", \"stddev_ms\": " << sampleStddev(c.times)
+                 << ", \"min_ms\": " << percentile(c.times, 0.0)
+                 << ", \"max_ms\": " << percentile(c.times, 1.0)
+                 << ", \"revenue_mean\": " << c.revenue / samples
+                 << ", \"served_mean\": " << c.served / samples << "}";
+        }
+        file << "\n  ]\n}\n";
+
+        closeOutput(file, filename, "Summary");
+    }
+
+    // Una fila por fase o contador de cada corrida (sólo con ENABLE_TRACING)
+    void exportPhaseResults(const std::string& filename) {
+        std::ofstream file = openOutput(filename);
+
+        file << "algorithm,parameter_type,parameter_value,name,kind,value,total_ms\n";
+        for (const auto& phase : phase_results) {
+            file << phase.algorithm << ","
+                 << phase.parameter_type << ","
+                 << phase.parameter_value << ","
+                 << phase.name << ","
+                 << (phase.counter ? "counter" : "phase") << ","
+                 << phase.value << ","
+                 << std::fixed << std::setprecision(3) << phase.total_ms << "\n";
+        }
+
+        closeOutput(file, filename, "Phase timings");
     }
     
     // Ejecutar suite completo de benchmarks
@@ -315,6 +706,7 @@ public:
     
     void clearResults() {
         results.clear();
+        phase_results.clear();
     }
     
     const std::vector<BenchmarkResult>& getResults() const {
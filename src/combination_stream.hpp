@@ -0,0 +1,60 @@
+#ifndef COMBINATION_STREAM_HPP
+#define COMBINATION_STREAM_HPP
+
+#include <vector>
+
+// Recorre los subconjuntos de tamaño k de candidates en orden lexicográfico sin
+// materializarlos (memoria O(k)). En cada paso accept(depth, value) decide si el
+// prefijo extendido con value es viable; si devuelve false se poda todo lo que
+// empieza con ese prefijo.
+class CombinationStream {
+public:
+    CombinationStream(const std::vector<int>& candidates, int k)
+        : candidates(candidates), k(k), position(k + 1, 0), group(k, 0) {}
+
+    // Avanza a la siguiente combinación aceptada; false cuando se agotaron
+    template <typename Accept>
+    bool next(Accept&& accept) {
+        const int n = static_cast<int>(candidates.size());
+        if (k <= 0 || k > n) return false;
+
+        if (depth == k) {  // venimos de emitir: probar el siguiente valor del último nivel
+            depth--;
+            position[depth]++;
+        }
+
+        while (depth >= 0) {
+            if (position[depth] > n - (k - depth)) {  // no quedan suficientes candidatos
+                depth--;
+                if (depth >= 0) position[depth]++;
+                continue;
+            }
+
+            int value = candidates[position[depth]];
+            if (!accept(depth, value)) {
+                position[depth]++;
+                continue;
+            }
+
+            group[depth] = value;
+            if (depth + 1 == k) {
+                depth = k;
+                return true;
+            }
+            position[depth + 1] = position[depth] + 1;
+            depth++;
+        }
+        return false;
+    }
+
+    const std::vector<int>& current() const { return group; }
+
+private:
+    const std::vector<int>& candidates;
+    int k;
+    int depth = 0;
+    std::vector<int> position;  // posición en candidates elegida en cada nivel
+    std::vector<int> group;
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef GEOMETRY_HPP
+#define GEOMETRY_HPP
+
+#include <cmath>
+
+// Distancia euclidiana como sqrt(dx*dx + dy*dy) (no std::hypot): los kernels
+// vectoriales de slack hacen exactamente las mismas operaciones, así que escalar
+// y SIMD dan resultados idénticos bit a bit.
+inline double planarDistance(double dx, double dy) {
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+#endif
@@ -0,0 +1,36 @@
+#include "group_index.hpp"
+#include "trace.hpp"
+#include <algorithm>
+
+GroupIndex::GroupIndex(const AdditiveTree& tree)
+    : catalog(tree.catalog), ordered(tree.getAllNodes()) {
+    TRACE_SCOPE("group_index.sort");
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const TreeNode& a, const TreeNode& b) { return a.profit > b.profit; });
+    dead.assign(ordered.size(), 0);
+    alive = ordered.size();
+
+    requestStart.assign(catalog.size() + 1, 0);
+    for (const TreeNode& node : ordered) {
+        for (int id : node.requestIds) requestStart[catalog.indexOf(id) + 1]++;
+    }
+    for (size_t r = 0; r < catalog.size(); r++) requestStart[r + 1] += requestStart[r];
+
+    requestGroups.resize(requestStart.back());
+    std::vector<int> fill(requestStart.begin(), requestStart.end() - 1);
+    for (size_t pos = 0; pos < ordered.size(); pos++) {
+        for (int id : ordered[pos].requestIds) requestGroups[fill[catalog.indexOf(id)]++] = static_cast<int>(pos);
+    }
+}
+
+void GroupIndex::retire(int requestId) {
+    int r = catalog.indexOf(requestId);
+    if (r < 0) return;
+    for (int k = requestStart[r]; k < requestStart[r + 1]; k++) {
+        int pos = requestGroups[k];
+        if (!dead[pos]) {
+            dead[pos] = 1;
+            alive--;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef GROUP_INDEX_HPP
+#define GROUP_INDEX_HPP
+
+#include <vector>
+#include <cstddef>
+#include "additive_tree.hpp"
+
+// Índice persistente de los grupos de un árbol, ordenados por profit descendente
+// (empates en el orden de getAllNodes). Al asignar un request se marcan muertos,
+// vía un índice invertido request -> grupos, todos los grupos que lo contienen;
+// cada búsqueda recorre los vivos en orden y se detiene en el primero aceptado.
+// Los nodos apuntan a los datos del árbol, que debe vivir más que el índice.
+class GroupIndex {
+public:
+    explicit GroupIndex(const AdditiveTree& tree);
+
+    void retire(int requestId);
+
+    // Primer grupo vivo (en orden de profit) para el que accept(node) es true
+    template <typename Accept>
+    const TreeNode* findFirst(Accept&& accept);
+
+    size_t aliveCount() const { return alive; }
+
+private:
+    const RequestCatalog& catalog;
+    std::vector<TreeNode> ordered;
+    std::vector<char> dead;               // por posición en ordered
+    std::vector<int> requestStart;        // CSR: índice del catálogo -> rango en requestGroups
+    std::vector<int> requestGroups;       // posiciones en ordered
+    size_t head = 0;                      // antes de head todos están muertos
+    size_t alive = 0;
+};
+
+template <typename Accept>
+const TreeNode* GroupIndex::findFirst(Accept&& accept) {
+    while (head < ordered.size() && dead[head]) head++;
+    for (size_t pos = head; pos < ordered.size(); pos++) {
+        if (!dead[pos] && accept(ordered[pos])) return &ordered[pos];
+    }
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,325 @@
+#include "jsonl_reader.hpp"
+#include "parallel.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Recorre un objeto JSON plano cuyos valores son números, strings, literales o
+// arreglos de números; fn(key, values, count) recibe hasta 2 números por clave
+class FlatObjectParser {
+public:
+    explicit FlatObjectParser(std::string_view text) : p(text.data()), end(text.data() + text.size()) {}
+
+    template <typename Fn>
+    bool parse(Fn&& fn) {
+        skipSpace();
+        if (!consume('{')) return false;
+        skipSpace();
+        if (consume('}')) return atEnd();
+        while (true) {
+            std::string_view key;
+            if (!readString(key)) return false;
+            skipSpace();
+            if (!consume(':')) return false;
+            skipSpace();
+
+            double values[2];
+            int count = 0;
+            if (consume('[')) {
+                skipSpace();
+                while (!consume(']')) {
+                    double v;
+                    if (!readNumber(v)) return false;
+                    if (count < 2) values[count] = v;
+                    count++;
+                    skipSpace();
+                    if (consume(',')) skipSpace();
+                }
+            } else if (p < end && *p == '"') {
+                std::string_view ignored;
+                if (!readString(ignored)) return false;
+                count = -1;
+            } else if (p < end && (*p == 't' || *p == 'f' || *p == 'n')) {
+                while (p < end && *p >= 'a' && *p <= 'z') p++;
+                count = -1;
+            } else {
+                if (!readNumber(values[0])) return false;
+                count = 1;
+            }
+            if (count >= 0) fn(key, values, count);
+
+            skipSpace();
+            if (consume('}')) return atEnd();
+            if (!consume(',')) return false;
+            skipSpace();
+        }
+    }
+
+private:
+    const char* p;
+    const char* end;
+
+    void skipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    }
+    bool consume(char c) {
+        if (p < end && *p == c) {
+            p++;
+            return true;
+        }
+        return false;
+    }
+    bool atEnd() {
+        skipSpace();
+        return p == end;
+    }
+    bool readString(std::string_view& out) {
+        if (!consume('"')) return false;
+        const char* begin = p;
+        while (p < end && *p != '"') p += (*p == '\\') ? 2 : 1;
+        if (p >= end) return false;
+        out = std::string_view(begin, p - begin);
+        p++;
+        return true;
+    }
+    bool readNumber(double& out) {
+        auto [next, error] = std::from_chars(p, end, out);  // sin locale
+        if (error != std::errc()) return false;
+        p = next;
+        return true;
+    }
+};
+
+bool isInteger(double v) {
+    return std::isfinite(v) && v == std::floor(v) && std::abs(v) < 2147483648.0;
+}
+
+// Archivo de texto completo mapeado en memoria (sólo lectura)
+class MappedText {
+public:
+    MappedText(const std::string& path, const char* what) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error(std::string(what) + ": cannot open " + path);
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error(std::string(what) + ": cannot stat " + path);
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error(std::string(what) + ": mmap failed for " + path);
+            }
+            data = static_cast<const char*>(mapped);
+            ::madvise(mapped, length, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+    ~MappedText() {
+        if (data) ::munmap(const_cast<char*>(data), length);
+    }
+    MappedText(const MappedText&) = delete;
+    MappedText& operator=(const MappedText&) = delete;
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    size_t size() const { return length; }
+
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+};
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t firstLine = 1, lines = 0;  // números de línea (desde 1)
+    size_t firstRow = 0, rows = 0;    // filas = líneas no vacías
+    size_t badLine = 0;               // 0 = sin errores
+};
+
+bool isBlank(const char* begin, const char* end) {
+    for (const char* p = begin; p < end; p++) {
+        if (*p != ' ' && *p != '\t' && *p != '\r') return false;
+    }
+    return true;
+}
+
+// fn(line, lineNumberInChunk) por cada línea no vacía; memchr busca los saltos de línea
+// con instrucciones vectoriales. Si fn devuelve false se detiene. Devuelve las líneas
+// recorridas, vacías incluidas.
+template <typename Fn>
+size_t forEachLine(const char* begin, const char* end, Fn&& fn) {
+    size_t number = 0;
+    for (const char* p = begin; p < end; number++) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* lineEnd = newline ? newline : end;
+        if (!isBlank(p, lineEnd) && !fn(std::string_view(p, lineEnd - p), number)) return number + 1;
+        p = lineEnd + 1;
+    }
+    return number;
+}
+
+constexpr size_t MIN_CHUNK_BYTES = 1 << 16;  // bloques más chicos no compensan un hilo
+
+// allocate(rows) reserva las filas y devuelve la primera; parse(line, row) escribe una
+template <typename Allocate, typename Parse>
+void parseJsonl(const std::string& path, const char* what, int numThreads, Allocate&& allocate, Parse&& parse) {
+    MappedText text(path, what);
+    int threads = resolveThreadCount(numThreads);
+
+    size_t pieces = std::max<size_t>(1, std::min<size_t>(static_cast<size_t>(threads) * 4, text.size() / MIN_CHUNK_BYTES));
+    if (threads == 1) pieces = 1;
+    std::vector<Chunk> chunks;
+    const char* start = text.begin();
+    for (size_t k = 1; k <= pieces && start < text.end(); k++) {
+        const char* cut = k == pieces ? text.end() : text.begin() + text.size() * k / pieces;
+        if (cut < start) cut = start;
+        if (cut < text.end()) {  // cortar después del próximo fin de línea
+            const char* newline = static_cast<const char*>(std::memchr(cut, '\n', text.end() - cut));
+            cut = newline ? newline + 1 : text.end();
+        }
+        chunks.push_back({start, cut});
+        start = cut;
+    }
+
+    parallelFor(chunks.size(), threads, [&](size_t c) {
+        Chunk& chunk = chunks[c];
+        chunk.lines = forEachLine(chunk.begin, chunk.end, [&](std::string_view, size_t) {
+            chunk.rows++;
+            return true;
+        });
+    });
+    size_t rows = 0, lines = 1;
+    for (Chunk& chunk : chunks) {
+        chunk.firstRow = rows;
+        chunk.firstLine = lines;
+        rows += chunk.rows;
+        lines += chunk.lines;
+    }
+
+    size_t first = allocate(rows);
+    parallelFor(chunks.size(), threads, [&](size_t c) {
+        Chunk& chunk = chunks[c];
+        size_t row = first + chunk.firstRow;
+        forEachLine(chunk.begin, chunk.end, [&](std::string_view line, size_t number) {
+            if (parse(line, row++)) return true;
+            chunk.badLine = chunk.firstLine + number;
+            return false;
+        });
+    });
+    for (const Chunk& chunk : chunks) {
+        if (chunk.badLine) {
+            throw std::runtime_error(std::string(what) + ": bad record at " + path + ":" + std::to_string(chunk.badLine));
+        }
+    }
+}
+
+}
+
+bool parseRequestLine(std::string_view line, Request& out) {
+    enum { ID = 1, ORIGIN = 2, DESTINATION = 4, RELEASE = 8, DEADLINE = 16, PAYMENT = 32, ALL = 63 };
+    int seen = 0;
+    bool valid = true;
+    FlatObjectParser parser(line);
+    bool parsed = parser.parse([&](std::string_view key, const double* v, int count) {
+        if (key == "id" && count == 1 && isInteger(v[0])) {
+            out.id = static_cast<int>(v[0]);
+            seen |= ID;
+        } else if (key == "origin" && count == 2) {
+            out.origin = {v[0], v[1]};
+            seen |= ORIGIN;
+        } else if (key == "destination" && count == 2) {
+            out.destination = {v[0], v[1]};
+            seen |= DESTINATION;
+        } else if (key == "release_time" && count == 1 && isInteger(v[0])) {
+            out.releaseTime = static_cast<int>(v[0]);
+            seen |= RELEASE;
+        } else if (key == "deadline" && count == 1 && isInteger(v[0])) {
+            out.deadline = static_cast<int>(v[0]);
+            seen |= DEADLINE;
+        } else if (key == "payment" && count == 1) {
+            out.payment = v[0];
+            seen |= PAYMENT;
+        } else if (key == "id" || key == "origin" || key == "destination" || key == "release_time" ||
+                   key == "deadline" || key == "payment") {
+            valid = false;  // campo conocido con un valor del tipo equivocado
+        }
+    });
+    return parsed && valid && seen == ALL;
+}
+
+bool parseVehicleLine(std::string_view line, Vehicle& out) {
+    enum { ID = 1, LOCATION = 2, CAPACITY = 4, ALL = 7 };
+    int seen = 0;
+    bool valid = true;
+    FlatObjectParser parser(line);
+    bool parsed = parser.parse([&](std::string_view key, const double* v, int count) {
+        if (key == "id" && count == 1 && isInteger(v[0])) {
+            out.id = static_cast<int>(v[0]);
+            seen |= ID;
+        } else if (key == "location" && count == 2) {
+            out.location = {v[0], v[1]};
+            seen |= LOCATION;
+        } else if (key == "capacity" && count == 1 && isInteger(v[0])) {
+            out.capacity = static_cast<int>(v[0]);
+            seen |= CAPACITY;
+        } else if (key == "id" || key == "location" || key == "capacity") {
+            valid = false;
+        }
+    });
+    return parsed && valid && seen == ALL;
+}
+
+std::vector<Request> readRequestsJsonl(const std::string& path, int numThreads) {
+    std::vector<Request> result;
+    parseJsonl(path, "readRequestsJsonl", numThreads,
+               [&](size_t rows) {
+                   result.resize(rows);
+                   return size_t{0};
+               },
+               [&](std::string_view line, size_t row) { return parseRequestLine(line, result[row]); });
+    return result;
+}
+
+std::vector<Vehicle> readVehiclesJsonl(const std::string& path, int numThreads) {
+    std::vector<Vehicle> result;
+    parseJsonl(path, "readVehiclesJsonl", numThreads,
+               [&](size_t rows) {
+                   result.resize(rows);
+                   return size_t{0};
+               },
+               [&](std::string_view line, size_t row) { return parseVehicleLine(line, result[row]); });
+    validateVehicles(result, "readVehiclesJsonl");
+    return result;
+}
+
+RequestCatalog loadRequestsJsonl(const std::string& path, TravelOracle travel, int numThreads) {
+    RequestCatalog catalog({}, std::move(travel));
+    parseJsonl(path, "loadRequestsJsonl", numThreads,
+               [&](size_t rows) { return catalog.appendRows(rows); },
+               [&](std::string_view line, size_t row) {
+                   Request r;
+                   if (!parseRequestLine(line, r)) return false;
+                   catalog.ids[row] = r.id;
+                   catalog.originX[row] = r.origin.first;
+                   catalog.originY[row] = r.origin.second;
+                   catalog.destX[row] = r.destination.first;
+                   catalog.destY[row] = r.destination.second;
+                   catalog.releaseTime[row] = r.releaseTime;
+                   catalog.deadline[row] = r.deadline;
+                   catalog.payment[row] = r.payment;
+                   return true;
+               });
+    catalog.commitRows(0);
+    return catalog;
+}
@@ -0,0 +1,32 @@
+#ifndef JSONL_READER_HPP
+#define JSONL_READER_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include "request.hpp"
+#include "vehicle.hpp"
+#include "request_catalog.hpp"
+
+// Entradas en JSONL, un objeto por línea (las claves desconocidas se ignoran):
+//   requests:  {"id": 1, "origin": [x, y], "destination": [x, y],
+//               "release_time": 0, "deadline": 300, "payment": 5}
+//   vehículos: {"id": 1, "location": [x, y], "capacity": 3}
+
+// false si la línea no es un objeto válido o le falta algún campo
+bool parseRequestLine(std::string_view line, Request& out);
+bool parseVehicleLine(std::string_view line, Vehicle& out);
+
+// Lectura de archivos completos: el archivo se mapea en memoria y se divide en bloques
+// que terminan en fin de línea; una primera pasada cuenta las filas de cada bloque y
+// la segunda parsea cada bloque en su propio hilo directo a su rango de filas, sin
+// copiar las líneas. numThreads = 0 usa todos los núcleos. Las líneas vacías se saltan;
+// lanzan std::runtime_error con el número de línea si alguna está mal formada y
+// std::invalid_argument si un vehículo excede MAX_VEHICLE_CAPACITY.
+std::vector<Request> readRequestsJsonl(const std::string& path, int numThreads = 0);
+std::vector<Vehicle> readVehiclesJsonl(const std::string& path, int numThreads = 0);
+
+// Igual que readRequestsJsonl pero escribiendo en las columnas del catálogo
+RequestCatalog loadRequestsJsonl(const std::string& path, TravelOracle travel = {}, int numThreads = 0);
+
+#endif
@@ -1,4 +1,7 @@
 #include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
 #include "request.hpp"
 #include "vehicle.hpp"
 #include "planner_gas.hpp"
@@ -6,6 +9,9 @@
 #include "planner_gaso1.hpp"
 #include "planner_gaso2.hpp"
 #include "utils.hpp"
+#include "jsonl_reader.hpp"
+#include "parallel.hpp"
+#include "request_file.hpp"
 
 enum GASVariant {
     GAS,
@@ -14,13 +20,12 @@ enum GASVariant {
 };
 
 void benchmarkTest(int numRequests, int numVehicles) { //generacion aleatoria de vehiculos
-    auto requests = generateRandomRequests(numRequests);
+    RequestCatalog catalog(generateRandomRequests(numRequests));
     auto vehicles = generateVehicles(numVehicles);
 
     std::cout << "=== Benchmark: " << numRequests << " requests, " << numVehicles << " vehicles ===\n";
 
     for (int variant = GAS; variant <= GAS_O2; ++variant) {
-        std::vector<Request> rCopy = requests;
         std::vector<Vehicle> vCopy = vehicles;
 
         std::cout << ((variant == GAS)     ? "[GAS]" :
@@ -28,39 +33,69 @@ void benchmarkTest(int numRequests, int numVehicles) { //generacion aleatoria de
                       "[GAS-O2]") << "\n";
 
         switch (variant) {
-            case GAS:    planRoutesGAS(rCopy, vCopy); break;
-            case GAS_O1: planRoutesGASO1(rCopy, vCopy); break;
-            case GAS_O2: planRoutesGASO2(rCopy, vCopy); break;
+            case GAS:    planRoutesGAS(catalog, vCopy); break;
+            case GAS_O1: planRoutesGASO1(catalog, vCopy); break;
+            case GAS_O2: planRoutesGASO2(catalog, vCopy); break;
         }
 
         std::cout << std::endl;
     }
 }
 
-void runTestCase(const std::string& title, const std::vector<Request>& requestsInput, const std::vector<Vehicle>& vehiclesInput) {
-    std::cout << "==== CASO: " << title << " ====\n";
+void runVariants(const RequestCatalog& catalog, const std::vector<Vehicle>& vehiclesInput) {
     for (int variant = GAS; variant <= GAS_O2; ++variant) {
-        std::vector<Request> requests = requestsInput;
         std::vector<Vehicle> vehicles = vehiclesInput;
 
         switch (variant) {
             case GAS:
                 std::cout << "[GAS] -----------------------------\n";
-                planRoutesGAS(requests, vehicles);
+                planRoutesGAS(catalog, vehicles);
                 break;
             case GAS_O1:
                 std::cout << "[GAS-O1] (Add. Tree Global) ---\n";
-                planRoutesGASO1(requests, vehicles);
+                planRoutesGASO1(catalog, vehicles);
                 break;
             case GAS_O2:
                 std::cout << "[GAS-O2] (Add. Tree x Vehicle) -\n";
-                planRoutesGASO2(requests, vehicles);
+                planRoutesGASO2(catalog, vehicles);
                 break;
         }
         std::cout << std::endl;
     }
 }
 
+void runTestCase(const std::string& title, const std::vector<Request>& requestsInput, const std::vector<Vehicle>& vehiclesInput) {
+    std::cout << "==== CASO: " << title << " ====\n";
+    runVariants(RequestCatalog(requestsInput), vehiclesInput);
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Entradas .rspc (binario por columnas) o JSONL
+void runFromFiles(const std::string& requestPath, const std::string& vehiclePath, int numThreads) {
+    auto start = std::chrono::steady_clock::now();
+    RequestCatalog catalog = endsWith(requestPath, ".rspc") ? RequestFile(requestPath).catalog()
+                                                            : loadRequestsJsonl(requestPath, {}, numThreads);
+    std::vector<Vehicle> vehicles = endsWith(vehiclePath, ".rspc") ? VehicleFile(vehiclePath).vehicles()
+                                                                   : readVehiclesJsonl(vehiclePath, numThreads);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "=== " << requestPath << ": " << catalog.size() << " requests, " << vehicles.size()
+              << " vehicles (loaded in " << ms << " ms) ===\n";
+    runVariants(catalog, vehicles);
+}
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [--requests <file> --vehicles <file>] [--threads N] [--cases]\n";
+    std::cout << "  --requests FILE  Request log (.jsonl, or .rspc from ConvertInputs)\n";
+    std::cout << "  --vehicles FILE  Vehicle snapshot (.jsonl or .rspc)\n";
+    std::cout << "  --threads N      Threads used to parse JSONL (0 = hardware concurrency)\n";
+    std::cout << "  --cases          Run the hand-written test cases instead of the random benchmarks\n";
+    std::cout << "Without arguments runs the built-in random benchmarks.\n";
+}
+
 void defineTestCases() {
     runTestCase("Caso 0 - Caso de paper",
         {
@@ -117,11 +152,62 @@ void defineTestCases() {
         {
             {1, {0,0}, 3}
         });
+
+    runTestCase("Caso 5 - Ventana enorme (radio de la grilla fuera de rango int)",
+        {
+            {1, {0.1,0.1}, {0.9,0.9}, 0, 1000000000, 9},
+            {2, {0.2,0.1}, {0.8,0.9}, 0, 1000000000, 8},
+            {3, {0.1,0.2}, {0.9,0.8}, 0, 1000000000, 7},
+            {4, {0.9,0.1}, {0.1,0.9}, 0, 1000000000, 6},
+            {5, {0.8,0.2}, {0.2,0.8}, 0, 1000000000, 5},
+            {6, {0.9,0.2}, {0.1,0.8}, 0, 1000000000, 4}
+        },
+        {
+            {1, {0,0}, 3},
+            {2, {0,0}, 3}
+        });
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    std::string requestPath, vehiclePath;
+    int numThreads = 0;
+    bool runCases = false;
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (flag == "--requests" && i + 1 < argc) {
+            requestPath = argv[++i];
+        } else if (flag == "--vehicles" && i + 1 < argc) {
+            vehiclePath = argv[++i];
+        } else if (flag == "--threads" && i + 1 < argc) {
+            numThreads = std::atoi(argv[++i]);
+        } else if (flag == "--cases") {
+            runCases = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!requestPath.empty() || !vehiclePath.empty()) {
+        if (requestPath.empty() || vehiclePath.empty()) {
+            std::cerr << "Error: --requests and --vehicles must be given together" << std::endl;
+            return 1;
+        }
+        try {
+            TaskScheduler::configure(numThreads);  // el pool puede ser mayor que los núcleos
+            runFromFiles(requestPath, vehiclePath, numThreads);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     std::cout<<"!=== Testing Algorithms ===!"<<std::endl;
-    //defineTestCases();
+    if (runCases) {
+        defineTestCases();
+        return 0;
+    }
 
     benchmarkTest(30, 5);    // mediano
     benchmarkTest(100, 20);  // grande
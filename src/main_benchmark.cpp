@@ -1,10 +1,12 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <sched.h>
 #include "benchmark_suite.hpp"
+#include "slack_kernel.hpp"
 
 void printUsage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " [option]\n";
+    std::cout << "Usage: " << program_name << " [option] [--threads N] [flags]\n";
     std::cout << "Options:\n";
     std::cout << "  --all          Run complete benchmark suite\n";
     std::cout << "  --requests     Benchmark request variation\n";
@@ -12,7 +14,37 @@ void printUsage(const char* program_name) {
     std::cout << "  --capacity     Benchmark capacity variation\n";
     std::cout << "  --deadline     Benchmark deadline variation\n";
     std::cout << "  --quick        Run quick benchmark (smaller scale)\n";
+    std::cout << "  --online       Benchmark online dispatch over several epoch lengths\n";
+    std::cout << "  --churn        Benchmark incremental upkeep of the additive tree against rebuilding it\n";
     std::cout << "  --help         Show this help message\n";
+    std::cout << "Flags:\n";
+    std::cout << "  --threads N    Threads for additive tree construction (0 = all cores)\n";
+    std::cout << "  --parallel-vehicles  Score GAS-O2 vehicles in parallel, then commit (all cores unless --threads)\n";
+    std::cout << "  --no-spatial-index   Disable the request origin grid\n";
+    std::cout << "  --no-pair-graph      Disable the pairwise compatibility matrix\n";
+    std::cout << "  --optimize-route-order  Pick the best pickup/dropoff order for each group\n";
+    std::cout << "  --slack-kernel K     Slack kernel: auto, scalar, avx2, avx512 (default auto)\n";
+    std::cout << "  --metric M           Travel metric: euclidean, manhattan (default euclidean)\n";
+    std::cout << "  --travel-table FILE  Use a precomputed travel time table (points + matrix)\n";
+    std::cout << "  --replay FILE        With --online, replay a recorded request file (.rspc)\n";
+    std::cout << "  --fleet FILE         With --replay, vehicle snapshot (.rspc; default 20 generated)\n";
+    std::cout << "  --verify-tree        With --online, check GAS-O1's incremental tree against a rebuild each epoch\n";
+    std::cout << "  --trace FILE         Write a Chrome trace of planner phases (needs ENABLE_TRACING)\n";
+    std::cout << "  --seed S             Base seed; iteration i uses S + i for inputs and GAS-O2 (default 42)\n";
+    std::cout << "  --warmup N           Unmeasured runs of each planner per input (default 1)\n";
+    std::cout << "  --repetitions N      Measured runs of each planner per input (default 1)\n";
+    std::cout << "  --pin-cpu C          Pin the process (and its planner threads) to CPU C\n";
+    std::cout << "  --jobs N             Run N inputs concurrently on the task scheduler (default 1 = isolated;\n";
+    std::cout << "                       memory and phase columns are only measured when isolated)\n";
+    std::cout << "  --pin-workers        Pin each scheduler thread to its own CPU\n";
+}
+
+// Fija el proceso a un núcleo; los hilos creados después heredan la máscara
+bool pinToCpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
 }
 
 void runQuickBenchmark(BenchmarkSuite& suite) {
@@ -48,6 +80,119 @@ int main(int argc, char* argv[]) {
     std::string option = argv[1];
     BenchmarkSuite suite("benchmark_results");
     
+    PlannerOptions options;
+    TravelOracle travel;
+    std::string replay_file, fleet_file, trace_file;
+    HarnessOptions harness;
+    bool threads_given = false;
+    for (int i = 2; i < argc; i++) {
+        std::string flag = argv[i];
+        if (flag == "--threads" && i + 1 < argc) {
+            options.numThreads = std::atoi(argv[++i]);
+            threads_given = true;
+        } else if (flag == "--parallel-vehicles") {
+            options.parallelVehicles = true;
+        } else if (flag == "--no-spatial-index") {
+            options.spatialIndex = false;
+        } else if (flag == "--no-pair-graph") {
+            options.pairGraph = false;
+        } else if (flag == "--optimize-route-order") {
+            options.optimizeRouteOrder = true;
+        } else if (flag == "--metric" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "euclidean") travel = TravelOracle(TravelMetric::Euclidean);
+            else if (name == "manhattan") travel = TravelOracle(TravelMetric::Manhattan);
+            else {
+                std::cout << "Unknown metric: " << name << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (flag == "--travel-table" && i + 1 < argc) {
+            try {
+                auto table = loadTravelTable(argv[++i]);
+                if (table->repaired > 0) {
+                    std::cout << "Warning: travel table violates the triangle inequality; "
+                              << table->repaired << " times shortened to shortest paths" << std::endl;
+                }
+                travel = TravelOracle(TravelMetric::Table, table);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        } else if (flag == "--replay" && i + 1 < argc) {
+            replay_file = argv[++i];
+        } else if (flag == "--fleet" && i + 1 < argc) {
+            fleet_file = argv[++i];
+        } else if (flag == "--verify-tree") {
+            harness.verify_tree = true;
+        } else if (flag == "--seed" && i + 1 < argc) {
+            harness.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            if (harness.seed == 0) {
+                std::cerr << "Error: --seed must be positive (0 means non-reproducible)" << std::endl;
+                return 1;
+            }
+        } else if (flag == "--warmup" && i + 1 < argc) {
+            harness.warmup_runs = std::max(0, std::atoi(argv[++i]));
+        } else if (flag == "--repetitions" && i + 1 < argc) {
+            harness.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (flag == "--pin-cpu" && i + 1 < argc) {
+            harness.pinned_cpu = std::atoi(argv[++i]);
+        } else if (flag == "--jobs" && i + 1 < argc) {
+            harness.jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (flag == "--pin-workers") {
+            harness.pinned_workers = true;
+        } else if (flag == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+            if (!trace::compiledIn()) {
+                std::cerr << "Error: --trace needs a build with -DENABLE_TRACING=ON" << std::endl;
+                return 1;
+            }
+            trace::setRecording(true);
+        } else if (flag == "--slack-kernel" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "auto") setSlackKernel(SlackKernel::Auto);
+            else if (name == "scalar") setSlackKernel(SlackKernel::Scalar);
+            else if (name == "avx2") setSlackKernel(SlackKernel::AVX2);
+            else if (name == "avx512") setSlackKernel(SlackKernel::AVX512);
+            else {
+                std::cout << "Unknown slack kernel: " << name << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            std::cout << "Unknown flag: " << flag << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.parallelVehicles) {
+        if (!threads_given) options.numThreads = 0;  // sin --threads el modo paralelo sería serial
+        else if (options.numThreads == 1) {
+            std::cout << "Warning: --parallel-vehicles with --threads 1 scores vehicles serially" << std::endl;
+        }
+    }
+    if (harness.pinned_cpu >= 0 && harness.pinned_workers) {
+        std::cerr << "Error: --pin-cpu and --pin-workers are mutually exclusive" << std::endl;
+        return 1;
+    }
+    if (harness.pinned_cpu >= 0) {
+        if (!pinToCpu(harness.pinned_cpu)) {
+            std::cerr << "Error: cannot pin to CPU " << harness.pinned_cpu << std::endl;
+            return 1;
+        }
+        if (options.numThreads != 1) {
+            std::cout << "Warning: --pin-cpu runs every planner thread on CPU " << harness.pinned_cpu << std::endl;
+        }
+    }
+    // un solo pool para las entradas concurrentes y el paralelismo de cada planner
+    TaskScheduler::configure(std::max(resolveThreadCount(options.numThreads), harness.jobs), harness.pinned_workers);
+    suite.setPlannerOptions(options);
+    suite.setTravelOracle(travel);
+    suite.setHarnessOptions(harness);
+    std::cout << "Slack kernel: " << slackKernelName(activeSlackKernel())
+              << ", travel metric: " << travel.name()
+              << ", scheduler threads: " << TaskScheduler::instance().threads() << std::endl;
+    
     try {
         if (option == "--help") {
             printUsage(argv[0]);
@@ -77,6 +222,21 @@ int main(int argc, char* argv[]) {
             suite.benchmarkCapacityVariation({2, 3, 4, 5, 6}, 150, 20, 900, 5);
             suite.exportResults("capacity_variation_results.csv");
         }
+        else if (option == "--online") {
+            std::cout << "Running Online Dispatch Benchmark..." << std::endl;
+            if (replay_file.empty()) {
+                suite.benchmarkOnlineDispatch({15, 30, 60, 120}, 600, 8, 3, 150, 1200);
+            } else {
+                auto fleet = fleet_file.empty() ? generateVehicles(20, 3, 10, harness.seed) : VehicleFile(fleet_file).vehicles();
+                suite.benchmarkOnlineReplay({15, 30, 60, 120}, replay_file, fleet);
+            }
+            suite.exportOnlineResults("online_results.csv");
+        }
+        else if (option == "--churn") {
+            std::cout << "Running Tree Churn Benchmark..." << std::endl;
+            suite.benchmarkTreeChurn({1, 5, 10, 25, 50}, 200, 3, 300);
+            suite.exportChurnResults("tree_churn_results.csv");
+        }
         else if (option == "--deadline") {
             std::cout << "Running Deadline Variation Benchmark..." << std::endl;
             suite.benchmarkDeadlineVariation({450, 600, 750, 900, 1050, 1200, 1350}, 150, 20, 3, 5);
@@ -88,6 +248,11 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        if (!trace_file.empty()) {
+            trace::writeChromeTrace(trace_file);
+            std::cout << "Trace written to: " << trace_file << std::endl;
+        }
+
         std::cout << "\nBenchmark completed successfully!" << std::endl;
         std::cout << "Results saved in: benchmark_results/" << std::endl;
         
@@ -0,0 +1,45 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include "jsonl_reader.hpp"
+#include "request_file.hpp"
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " --requests|--vehicles <input.jsonl> <output.rspc>\n";
+    std::cout << "  --requests     Convert a request log (rows are sorted by release time)\n";
+    std::cout << "  --vehicles     Convert a vehicle snapshot\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    std::string kind = argv[1], input = argv[2], output = argv[3];
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        size_t rows = 0;
+        if (kind == "--requests") {
+            auto requests = readRequestsJsonl(input);
+            std::stable_sort(requests.begin(), requests.end(),
+                             [](const Request& a, const Request& b) { return a.releaseTime < b.releaseTime; });
+            writeRequestFile(output, requests);
+            rows = requests.size();
+        } else if (kind == "--vehicles") {
+            auto vehicles = readVehiclesJsonl(input);
+            writeVehicleFile(output, vehicles);
+            rows = vehicles.size();
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Wrote " << rows << " rows to " << output << " in " << ms << " ms" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
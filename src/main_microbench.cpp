@@ -0,0 +1,186 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "request_catalog.hpp"
+#include "additive_tree.hpp"
+#include "combination_stream.hpp"
+#include "planner_gaso2.hpp"
+#include "slack_kernel.hpp"
+#include "memory_tracker.hpp"
+#include "utils.hpp"
+
+// Microbenchmarks de los kernels calientes, cada uno con n requests y capacidad (o
+// tamaño de grupo k) como argumentos. items_per_second cuenta la unidad de trabajo
+// del kernel; con la memoria registrada abajo cada caso informa también asignaciones
+// y bytes. Los contadores de hardware se piden con --benchmark_perf_counters=CYCLES,...
+// (si Google Benchmark se compiló con libpfm) o corriendo el binario bajo perf stat
+// con --benchmark_filter.
+
+namespace {
+
+constexpr unsigned SEED = 42;
+constexpr int DEADLINE_WINDOW = 900;  // mismo ajuste que BenchmarkSuite
+
+RequestCatalog makeCatalog(int n) {
+    auto requests = generateRandomRequests(n, 50, 100, 10, SEED);
+    for (auto& r : requests) r.deadline = r.releaseTime + DEADLINE_WINDOW;
+    return RequestCatalog(requests);
+}
+
+Vehicle makeVehicle(int capacity) {
+    return generateVehicles(1, capacity, 10, SEED)[0];
+}
+
+// Asignaciones y bytes del contador global de memory_tracker.cpp
+class CountingMemoryManager : public benchmark::MemoryManager {
+public:
+    void Start() override { probe.start(); }
+    void Stop(Result* result) override { Stop(*result); }
+    void Stop(Result& result) override {
+        MemoryUsage usage = probe.stop();
+        constexpr double MB = 1024.0 * 1024.0;
+        result.num_allocs = static_cast<int64_t>(usage.allocations);
+        result.max_bytes_used = static_cast<int64_t>(usage.peakLiveMb * MB);
+        result.total_allocated_bytes = static_cast<int64_t>(usage.allocatedMb * MB);
+    }
+
+private:
+    MemoryProbe probe;
+};
+
+// calculateMinSlack sobre grupos aleatorios de k requests; un ítem es un grupo
+void BM_MinSlack(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int k = static_cast<int>(state.range(1));
+    RequestCatalog catalog = makeCatalog(n);
+    Vehicle vehicle = makeVehicle(k);
+
+    std::mt19937 rng(SEED);
+    std::vector<int> indices = catalog.allIndices();
+    std::vector<std::vector<int>> groups(256);
+    for (auto& group : groups) {
+        std::shuffle(indices.begin(), indices.end(), rng);
+        group.assign(indices.begin(), indices.begin() + k);
+    }
+
+    size_t g = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(calculateMinSlack(vehicle, catalog, groups[g]));
+        g = (g + 1) % groups.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Kernel en lote (el que usa el árbol): todos los requests como extensión de la ruta
+// vacía; un ítem es un request evaluado
+void BM_MinSlackBatch(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    RequestCatalog catalog = makeCatalog(n);
+    RouteState start = startRoute(catalog, makeVehicle(1));
+    std::vector<int> indices = catalog.allIndices();
+    std::vector<double> slack(n), endTime(n);
+
+    for (auto _ : state) {
+        calculateMinSlackBatch(start, catalog, 1, indices.data(), indices.size(), slack.data(), endTime.data());
+        benchmark::DoNotOptimize(slack.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetLabel(slackKernelName(activeSlackKernel()));
+}
+
+// Árbol aditivo global hasta el nivel capacity; un ítem es un nodo construido
+void BM_TreeBuild(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int capacity = static_cast<int>(state.range(1));
+    RequestCatalog catalog = makeCatalog(n);
+
+    size_t nodes = 0;
+    for (auto _ : state) {
+        AdditiveTree tree(catalog, capacity);
+        nodes = tree.nodeCount();
+        benchmark::DoNotOptimize(nodes);
+    }
+    state.SetItemsProcessed(state.iterations() * nodes);
+    state.counters["nodes"] = static_cast<double>(nodes);
+}
+
+// Recorrido del árbol materializando cada grupo; un ítem es un nodo
+void BM_GetAllNodes(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int capacity = static_cast<int>(state.range(1));
+    RequestCatalog catalog = makeCatalog(n);
+    AdditiveTree tree(catalog, capacity);
+
+    for (auto _ : state) {
+        std::vector<TreeNode> nodes = tree.getAllNodes();
+        benchmark::DoNotOptimize(nodes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * tree.nodeCount());
+}
+
+// Filtro de alcance de GAS-O2 sobre todos los requests; un ítem es un request
+void BM_FilterFeasible(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    RequestCatalog catalog = makeCatalog(n);
+    Vehicle vehicle = makeVehicle(3);
+    std::vector<int> candidates = catalog.allIndices();
+
+    for (auto _ : state) {
+        std::vector<int> feasible = filterFeasibleRequests(vehicle, catalog, candidates);
+        benchmark::DoNotOptimize(feasible.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Enumeración de combinaciones de k requests sin poda (la de GAS); un ítem es una combinación
+void BM_Combinations(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int k = static_cast<int>(state.range(1));
+    std::vector<int> candidates(n);
+    for (int i = 0; i < n; i++) candidates[i] = i;
+
+    size_t count = 0;
+    for (auto _ : state) {
+        CombinationStream stream(candidates, k);
+        count = 0;
+        while (stream.next([](int, int) { return true; })) count++;
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Traducción id -> índice del catálogo en orden aleatorio; un ítem es una consulta
+void BM_IndexOf(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    RequestCatalog catalog = makeCatalog(n);
+    std::vector<int> ids(catalog.ids.begin(), catalog.ids.end());
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(SEED));
+
+    for (auto _ : state) {
+        for (int id : ids) benchmark::DoNotOptimize(catalog.indexOf(id));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * sizeof(int));
+}
+
+}
+
+BENCHMARK(BM_MinSlack)->ArgNames({"n", "k"})->ArgsProduct({{100}, {1, 2, 3, 4, 5, 6}});
+BENCHMARK(BM_MinSlackBatch)->ArgName("n")->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK(BM_TreeBuild)->ArgNames({"n", "capacity"})->ArgsProduct({{25, 50, 100}, {2, 3, 4}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GetAllNodes)->ArgNames({"n", "capacity"})->ArgsProduct({{25, 50, 100}, {2, 3}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FilterFeasible)->ArgName("n")->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK(BM_Combinations)->ArgNames({"n", "k"})->ArgsProduct({{25, 50, 100}, {2, 3}});
+BENCHMARK(BM_IndexOf)->ArgName("n")->RangeMultiplier(4)->Range(64, 1 << 20);
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    CountingMemoryManager memory;
+    benchmark::RegisterMemoryManager(&memory);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::RegisterMemoryManager(nullptr);
+    benchmark::Shutdown();
+    return 0;
+}
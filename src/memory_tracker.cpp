@@ -0,0 +1,101 @@
+#include "memory_tracker.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <malloc.h>
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{0};
+std::atomic<uint64_t> allocatedBytes{0};
+std::atomic<int64_t> liveBytes{0};
+std::atomic<int64_t> peakLiveBytes{0};
+
+void* countedAlloc(size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (!p) return nullptr;
+    int64_t usable = static_cast<int64_t>(malloc_usable_size(p));
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(usable, std::memory_order_relaxed);
+    int64_t live = liveBytes.fetch_add(usable, std::memory_order_relaxed) + usable;
+    int64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    return p;
+}
+
+void* countedNew(size_t size) {
+    for (;;) {
+        if (void* p = countedAlloc(size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void countedFree(void* p) noexcept {
+    if (!p) return;
+    liveBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(p)), std::memory_order_relaxed);
+    std::free(p);
+}
+
+// Campo en kB de /proc/self/status (VmRSS, VmHWM); -1 si no existe
+long statusKb(const std::string& field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size(), field) == 0 && line.size() > field.size() && line[field.size()] == ':') {
+            return std::strtol(line.c_str() + field.size() + 1, nullptr, 10);
+        }
+    }
+    return -1;
+}
+
+// "5" reinicia VmHWM al RSS actual (Linux >= 4.0)
+bool resetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.close();
+    return static_cast<bool>(clearRefs);
+}
+
+constexpr double MB = 1024.0 * 1024.0;
+
+}
+
+// Las variantes con alineación extendida quedan con la implementación por defecto
+// (no se cuentan); new y delete de cada una siguen emparejados.
+void* operator new(size_t size) { return countedNew(size); }
+void* operator new[](size_t size) { return countedNew(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+
+void MemoryProbe::start() {
+    malloc_trim(0);
+    rssReset = resetPeakRss();
+    baselineRssKb = statusKb("VmRSS");
+    allocationCount = 0;
+    allocatedBytes = 0;
+    baselineLiveBytes = liveBytes.load();
+    peakLiveBytes = baselineLiveBytes;
+}
+
+MemoryUsage MemoryProbe::stop() const {
+    MemoryUsage usage;
+    long peakKb = statusKb("VmHWM");
+    if (rssReset && peakKb >= 0 && baselineRssKb >= 0) {
+        usage.peakRssMb = std::max(0L, peakKb - baselineRssKb) / 1024.0;
+    }
+    usage.allocations = allocationCount.load();
+    usage.allocatedMb = allocatedBytes.load() / MB;
+    usage.peakLiveMb = std::max<int64_t>(0, peakLiveBytes.load() - baselineLiveBytes) / MB;
+    return usage;
+}
@@ -0,0 +1,31 @@
+#ifndef MEMORY_TRACKER_HPP
+#define MEMORY_TRACKER_HPP
+
+#include <cstdint>
+
+// Medición de memoria de una ejecución. memory_tracker.cpp reemplaza el operator
+// new/delete global para contar asignaciones, así que sólo se enlaza en los
+// ejecutables que miden (BenchmarkSuite). Los bytes son los que entrega malloc
+// (malloc_usable_size), incluido el redondeo del asignador.
+struct MemoryUsage {
+    double peakRssMb = -1.0;   // crecimiento del pico de RSS (-1 si el kernel no permite reiniciarlo)
+    uint64_t allocations = 0;  // llamadas a operator new
+    double allocatedMb = 0.0;  // total pedido, aunque se haya liberado
+    double peakLiveMb = 0.0;   // pico de memoria viva en el heap por encima del inicio
+};
+
+// Mide entre start() y stop(). Antes de empezar devuelve al sistema la memoria libre
+// del heap y reinicia el pico de RSS (/proc/self/clear_refs), de modo que cada
+// planner parte del RSS actual y no del pico de las corridas anteriores.
+class MemoryProbe {
+public:
+    void start();
+    MemoryUsage stop() const;
+
+private:
+    long baselineRssKb = 0;
+    bool rssReset = false;
+    int64_t baselineLiveBytes = 0;
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include "online_dispatcher.hpp"
+#include "additive_tree.hpp"
+#include "route_planner.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+OnlineDispatcher::OnlineDispatcher(std::vector<Vehicle> fleet, DispatchOptions options)
+    : fleet(std::move(fleet)), state(this->fleet.size()), options(std::move(options)),
+      catalog({}, this->options.travel) {
+    if (this->options.epochLength <= 0) throw std::invalid_argument("OnlineDispatcher: epoch length must be positive");
+    if (!this->options.planner && !this->options.treePlanner) throw std::invalid_argument("OnlineDispatcher: no planner given");
+    validateVehicles(this->fleet, "OnlineDispatcher");
+    std::unordered_set<int> ids;  // los resultados vuelven a la flota por id
+    for (const auto& v : this->fleet) {
+        if (!ids.insert(v.id).second) {
+            throw std::invalid_argument("OnlineDispatcher: duplicate vehicle id " + std::to_string(v.id));
+        }
+    }
+    for (const auto& v : this->fleet) treeCapacity = std::max(treeCapacity, v.capacity);
+}
+
+OnlineDispatcher::~OnlineDispatcher() = default;
+
+void OnlineDispatcher::submit(const Request& request) {
+    if (!incoming.empty() && request.releaseTime < incoming.back().releaseTime) sorted = false;
+    incoming.push_back(request);
+    submitted++;
+}
+
+void OnlineDispatcher::sortIncoming() {
+    if (sorted) return;
+    std::stable_sort(incoming.begin() + nextArrival, incoming.end(),
+                     [](const Request& a, const Request& b) { return a.releaseTime < b.releaseTime; });
+    sorted = true;
+}
+
+// Las ventanas siguen alineadas a múltiplos de epochLength
+void OnlineDispatcher::skipTo(int release) {
+    if (catalog.size() > 0 || release <= now + options.epochLength) return;
+    int skipped = (release - now - 1) / options.epochLength;
+    now += skipped * options.epochLength;
+    epoch += skipped;
+}
+
+// Quita del catálogo las filas con keep == 0; el árbol las retira al sincronizarse
+void OnlineDispatcher::dropRows(const std::vector<char>& keep) {
+    if (std::find(keep.begin(), keep.end(), 0) == keep.end()) return;
+    if (tree) {
+        for (size_t r = 0; r < keep.size(); r++) {
+            if (!keep[r]) treeRetired.push_back(catalog.ids[r]);
+        }
+    }
+    catalog.compact(keep);
+}
+
+// Pone el árbol al día con el catálogo: primero salen los retirados, después los
+// grupos que quedan se reevalúan si corrió el tiempo y al final entran los nuevos
+// (evaluados ya con los tiempos actuales). Sólo insert genera grupos nuevos. Con
+// mucha rotación sale más barato reconstruir (insert cuesta por grupo nuevo, y
+// removeNodes desplaza la cola de cada nivel desde el primer cambio).
+void OnlineDispatcher::syncTree() {
+    double churn = static_cast<double>(treeRetired.size() + treeAdded.size());
+    if (!tree || churn > options.treeRebuildChurn * catalog.size()) {
+        tree = std::make_unique<AdditiveTree>(catalog, treeCapacity, options.plannerOptions);
+    } else {
+        tree->retire(treeRetired);
+        tree->revalidate(catalogTime - treeTime);
+        std::vector<int> indices;
+        for (int id : treeAdded) {
+            int r = catalog.indexOf(id);
+            if (r >= 0) indices.push_back(r);  // los que vencieron antes de entrar no están
+        }
+        tree->insert(indices);
+    }
+    treeRetired.clear();
+    treeAdded.clear();
+    treeTime = catalogTime;
+
+    if (options.verifyTree && !tree->sameNodes(AdditiveTree(catalog, treeCapacity, options.plannerOptions))) {
+        throw std::logic_error("OnlineDispatcher: incremental tree differs from a rebuild");
+    }
+}
+
+EpochReport OnlineDispatcher::runEpoch() {
+    sortIncoming();
+
+    EpochReport report;
+    report.epoch = epoch++;
+    now += options.epochLength;
+    report.time = now;
+    auto start = std::chrono::steady_clock::now();
+
+    // la ronda ve el tiempo relativo a now: los vehículos libres arrancan en 0
+    catalog.shiftTimes(now - catalogTime);
+    catalogTime = now;
+    while (nextArrival < incoming.size() && incoming[nextArrival].releaseTime <= now) {
+        Request r = incoming[nextArrival++];
+        r.releaseTime -= now;
+        r.deadline -= now;
+        catalog.add(r);
+        if (tree) treeAdded.push_back(r.id);
+    }
+
+    // fuera los que ni un vehículo parado en su origen llegaría a dejar a tiempo
+    std::vector<char> keep(catalog.size(), 1);
+    for (size_t r = 0; r < catalog.size(); r++) {
+        double begin = std::max(0, catalog.releaseTime[r]);
+        if (catalog.deadline[r] - (begin + catalog.tripTime[r]) >= 1.0) continue;
+        keep[r] = 0;
+        report.expired++;
+    }
+    expiredCount += report.expired;
+    dropRows(keep);
+    report.pending = catalog.size();
+
+    std::vector<Vehicle> available;
+    std::unordered_map<int, size_t> owner;  // id -> índice en fleet (GAS-O2 baraja available)
+    for (size_t v = 0; v < fleet.size(); v++) {
+        if (state[v].freeAt > now) continue;
+        available.push_back({fleet[v].id, fleet[v].location, fleet[v].capacity, {}, {}});
+        owner[fleet[v].id] = v;
+    }
+    report.availableVehicles = available.size();
+    if (catalog.size() == 0 || available.empty()) return report;
+
+    if (options.treePlanner) {
+        syncTree();
+        options.treePlanner(*tree, available, options.plannerOptions);
+    } else {
+        options.planner(catalog, available, options.plannerOptions);
+    }
+    report.latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    keep.assign(catalog.size(), 1);
+    for (const Vehicle& planned : available) {
+        if (planned.assignedRequestIds.empty()) continue;
+
+        size_t v = owner.at(planned.id);
+        Vehicle& vehicle = fleet[v];
+        for (int id : planned.assignedRequestIds) {
+            int r = catalog.indexOf(id);
+            keep[r] = 0;
+            vehicle.assignedRequestIds.push_back(id);
+            report.assigned++;
+            report.revenue += catalog.payment[r];
+            totalWait -= catalog.releaseTime[r];  // espera = now - liberación, y releaseTime es relativo a now
+        }
+
+        std::vector<RouteStop> route = planned.route;
+        if (route.empty()) {  // planner sin ruta explícita: orden secuencial
+            std::vector<int> group;
+            for (int id : planned.assignedRequestIds) group.push_back(catalog.indexOf(id));
+            route = sequentialRoute(catalog, group);
+        }
+        vehicle.route.insert(vehicle.route.end(), route.begin(), route.end());
+        state[v].freeAt = now + static_cast<int>(std::ceil(routeEndTime(catalog, planned, route)));
+        int last = catalog.indexOf(route.back().requestId);
+        vehicle.location = {catalog.destX[last], catalog.destY[last]};
+    }
+    dropRows(keep);
+
+    served += report.assigned;
+    revenue += report.revenue;
+    return report;
+}
+
+DispatchSummary OnlineDispatcher::run(const std::vector<Request>& stream) {
+    for (const auto& r : stream) submit(r);
+
+    std::vector<EpochReport> epochs;
+    while (!idle()) {
+        sortIncoming();
+        if (nextArrival < incoming.size()) skipTo(incoming[nextArrival].releaseTime);
+        epochs.push_back(runEpoch());
+    }
+    return summarize(std::move(epochs));
+}
+
+DispatchSummary OnlineDispatcher::run(RequestStream& stream) {
+    std::vector<EpochReport> epochs;
+    std::vector<Request> batch;
+    while (!stream.done() || !idle()) {
+        if (!stream.done() && idle()) skipTo(stream.nextRelease());
+        batch.clear();
+        stream.readUntil(now + options.epochLength, batch);  // lo que admite la próxima ronda
+        for (const auto& r : batch) submit(r);
+        epochs.push_back(runEpoch());
+    }
+    return summarize(std::move(epochs));
+}
+
+DispatchSummary OnlineDispatcher::summarize(std::vector<EpochReport> epochs) const {
+    DispatchSummary summary;
+    summary.epochs = std::move(epochs);
+    summary.totalRequests = submitted;
+    summary.served = served;
+    summary.expired = expiredCount;
+    summary.revenue = revenue;
+    summary.meanWait = served ? totalWait / served : 0.0;
+
+    std::vector<double> planned;  // rondas que efectivamente planificaron
+    for (const auto& e : summary.epochs) {
+        if (e.pending > 0 && e.availableVehicles > 0) planned.push_back(e.latencyMs);
+    }
+    summary.latencyP50 = percentile(planned, 0.50);
+    summary.latencyP95 = percentile(planned, 0.95);
+    summary.latencyP99 = percentile(planned, 0.99);
+    summary.latencyMax = percentile(planned, 1.0);
+    return summary;
+}
@@ -0,0 +1,117 @@
+#ifndef ONLINE_DISPATCHER_HPP
+#define ONLINE_DISPATCHER_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include "request.hpp"
+#include "vehicle.hpp"
+#include "request_catalog.hpp"
+#include "planner_options.hpp"
+#include "request_file.hpp"
+
+class AdditiveTree;
+
+using PlannerFunction = void (*)(const RequestCatalog&, std::vector<Vehicle>&, const PlannerOptions&);
+using TreePlannerFunction = void (*)(const AdditiveTree&, std::vector<Vehicle>&, const PlannerOptions&);
+
+struct DispatchOptions {
+    int epochLength = 60;                       // segundos entre rondas de planificación
+    PlannerFunction planner = nullptr;          // planRoutesGAS / GASO1 / GASO2 / Optimal
+    // Si está (planRoutesGASO1), se usa en lugar de planner con un árbol global que se
+    // mantiene entre rondas con insert/retire/revalidate en vez de reconstruirse (salvo
+    // que cambie más de treeRebuildChurn del catálogo). GAS-O2 no tiene esta vía: arma
+    // sus árboles por vehículo desde cero en cada ronda
+    TreePlannerFunction treePlanner = nullptr;
+    double treeRebuildChurn = 0.15;             // fracción de filas retiradas + agregadas que fuerza reconstruir
+    bool verifyTree = false;                    // comparar ese árbol con uno reconstruido en cada ronda (lento)
+    PlannerOptions plannerOptions;
+    TravelOracle travel;                        // métrica del catálogo de pendientes
+};
+
+// Resultado de una ronda
+struct EpochReport {
+    int epoch = 0;
+    int time = 0;                 // fin de la ventana: se planifica con lo liberado hasta aquí
+    size_t pending = 0;           // requests considerados en la ronda
+    size_t availableVehicles = 0;
+    size_t assigned = 0;
+    size_t expired = 0;           // descartados antes de planificar (ya no se pueden atender)
+    double revenue = 0.0;
+    double latencyMs = 0.0;       // tiempo de cómputo de la ronda (catálogo, árbol y planner)
+};
+
+struct DispatchSummary {
+    std::vector<EpochReport> epochs;
+    size_t totalRequests = 0;
+    size_t served = 0;
+    size_t expired = 0;
+    double revenue = 0.0;
+    double meanWait = 0.0;        // segundos promedio entre releaseTime y la asignación
+    double latencyP50 = 0.0, latencyP95 = 0.0, latencyP99 = 0.0, latencyMax = 0.0;  // ms por ronda
+};
+
+// Despacho en línea: los requests llegan según su releaseTime y se agrupan en ventanas
+// de epochLength segundos. Al cierre de cada ventana se planifica con los requests
+// pendientes y los vehículos libres; cada vehículo asignado queda ocupado hasta
+// terminar su ruta y reaparece en el destino de su última entrega. Lo que no se asigna
+// pasa a la ronda siguiente mientras todavía pueda atenderse. Los pendientes viven en
+// un único catálogo que se actualiza por ronda (llegadas con add, asignados y vencidos
+// con compact), así que el trabajo de mantenerlo depende de lo que cambia.
+class OnlineDispatcher {
+public:
+    OnlineDispatcher(std::vector<Vehicle> fleet, DispatchOptions options);
+    ~OnlineDispatcher();
+    OnlineDispatcher(const OnlineDispatcher&) = delete;  // el árbol apunta al catálogo propio
+    OnlineDispatcher& operator=(const OnlineDispatcher&) = delete;
+
+    void submit(const Request& request);  // los requests pueden llegar en cualquier orden
+    EpochReport runEpoch();               // planifica la ventana siguiente
+    bool idle() const { return catalog.size() == 0 && nextArrival >= incoming.size(); }
+
+    // Ingresa todo el stream y corre rondas hasta que no queda nada pendiente. Sin
+    // pendientes, las rondas vacías hasta la próxima liberación se saltan (no aparecen
+    // en epochs, aunque la numeración las cuenta)
+    DispatchSummary run(const std::vector<Request>& stream);
+    // Igual, leyendo del archivo sólo lo que se libera en cada ronda
+    DispatchSummary run(RequestStream& stream);
+
+    const std::vector<Vehicle>& vehicles() const { return fleet; }
+
+private:
+    DispatchSummary summarize(std::vector<EpochReport> epochs) const;
+    void sortIncoming();
+    void skipTo(int release);  // adelanta now hasta la ronda que admite release si no hay pendientes
+    void dropRows(const std::vector<char>& keep);
+    void syncTree();
+
+    struct FleetState {
+        int freeAt = 0;  // el vehículo está ocupado hasta este instante
+    };
+
+    std::vector<Vehicle> fleet;       // posición actual y todo lo asignado hasta ahora
+    std::vector<FleetState> state;
+    DispatchOptions options;
+
+    std::vector<Request> incoming;    // ordenados por releaseTime a partir de nextArrival
+    size_t nextArrival = 0;
+    bool sorted = true;
+
+    // Pendientes con los tiempos relativos a catalogTime: los vehículos libres arrancan en 0
+    RequestCatalog catalog;
+    int catalogTime = 0;
+
+    // Árbol global de treePlanner, al día con el catálogo en treeTime salvo por los
+    // cambios anotados desde entonces
+    std::unique_ptr<AdditiveTree> tree;
+    std::vector<int> treeRetired, treeAdded;  // ids
+    int treeTime = 0;
+    int treeCapacity = 0;
+
+    int epoch = 0;
+    int now = 0;
+    size_t served = 0, expiredCount = 0, submitted = 0;
+    double revenue = 0.0, totalWait = 0.0;
+};
+
+#endif
@@ -0,0 +1,180 @@
+#include "parallel.hpp"
+#include "trace.hpp"
+#include <iterator>
+#include <sched.h>
+
+namespace {
+
+std::mutex configMutex;
+int configuredThreads = 0;
+bool configuredPin = false;
+
+// El pool es un estático local creado después del registro de trace, así que al salir
+// del programa se destruye antes: los workers cierran sus buffers de trace al terminar
+std::unique_ptr<TaskScheduler>& current() {
+    trace::initialize();
+    static std::unique_ptr<TaskScheduler> pool;
+    return pool;
+}
+
+thread_local size_t workerQueue = 0;  // cola propia del hilo (0 = hilo externo)
+
+// Núcleos permitidos al proceso, en orden
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+void pinCurrentThread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);  // 0 = el hilo que llama
+}
+
+}
+
+void TaskScheduler::configure(int threads, bool pinWorkers) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    configuredThreads = threads;
+    configuredPin = pinWorkers;
+    current().reset();
+}
+
+TaskScheduler& TaskScheduler::instance() {
+    std::lock_guard<std::mutex> lock(configMutex);
+    std::unique_ptr<TaskScheduler>& pool = current();
+    if (!pool) pool.reset(new TaskScheduler(resolveThreadCount(configuredThreads), configuredPin));
+    return *pool;
+}
+
+TaskScheduler::TaskScheduler(int threads, bool pinWorkers) : pinWorkers(pinWorkers) {
+    size_t count = static_cast<size_t>(std::max(threads, 1)) - 1;
+    std::vector<int> cpus = pinWorkers ? allowedCpus() : std::vector<int>();
+    if (!cpus.empty()) pinCurrentThread(cpus[0]);
+
+    for (size_t q = 0; q <= count; q++) queues.push_back(std::make_unique<Queue>());
+    for (size_t w = 1; w <= count; w++) {
+        int cpu = cpus.empty() ? -1 : cpus[w % cpus.size()];
+        workers.emplace_back([this, w, cpu] { workerLoop(w, cpu); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void TaskScheduler::push(Job job) {
+    Queue& queue = *queues[workerQueue < queues.size() ? workerQueue : 0];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queued.fetch_add(1);
+    { std::lock_guard<std::mutex> lock(sleepMutex); }  // un worker a punto de dormir ya ve queued
+    wake.notify_one();
+}
+
+// Sin group toma el extremo pedido; con group, la tarea de ese grupo más cercana a él
+bool TaskScheduler::take(size_t index, bool newest, const TaskGroup* group, Job& job) {
+    Queue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    auto match = [group](const Job& j) { return !group || j.group == group; };
+    std::deque<Job>::iterator it;
+    if (newest) {
+        auto rit = std::find_if(queue.jobs.rbegin(), queue.jobs.rend(), match);
+        if (rit == queue.jobs.rend()) return false;
+        it = std::prev(rit.base());
+    } else {
+        it = std::find_if(queue.jobs.begin(), queue.jobs.end(), match);
+        if (it == queue.jobs.end()) return false;
+    }
+    job = std::move(*it);
+    queue.jobs.erase(it);
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool TaskScheduler::runOne(const TaskGroup* group) {
+    if (queued.load() == 0) return false;
+    const size_t own = workerQueue < queues.size() ? workerQueue : 0;
+    Job job;
+    bool found = own != 0 && take(own, true, group, job);  // lo propio, lo último encolado primero
+    for (size_t k = 0; !found && k < queues.size(); k++) {
+        size_t victim = (own + k) % queues.size();  // inyección y demás workers, lo más viejo
+        if (victim != own || own == 0) found = take(victim, false, group, job);
+    }
+    if (!found) return false;
+
+    std::exception_ptr failure;
+    try {
+        job.fn();
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    job.group->finish(failure);
+    return true;
+}
+
+void TaskScheduler::workerLoop(size_t index, int cpu) {
+    workerQueue = index;
+    if (cpu >= 0) pinCurrentThread(cpu);
+    while (true) {
+        if (runOne()) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+TaskGroup::~TaskGroup() {
+    drain();
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending.fetch_add(1);
+    scheduler.push({std::move(task), this});
+}
+
+void TaskGroup::wait() {
+    drain();
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
+
+// Mientras queden tareas del grupo en las colas las ejecuta el que espera; las demás
+// ya corren en otros hilos, así que se duerme hasta que finish avisa la última. Se
+// sale con doneMutex tomado una vez para que finish haya terminado de usar el grupo.
+void TaskGroup::drain() {
+    while (pending.load() > 0) {
+        if (scheduler.runOne(this)) continue;
+        std::unique_lock<std::mutex> lock(doneMutex);
+        done.wait(lock, [this] { return pending.load() == 0; });
+    }
+    std::lock_guard<std::mutex> lock(doneMutex);
+}
+
+void TaskGroup::finish(std::exception_ptr failure) {
+    if (failure) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) error = failure;
+    }
+    std::lock_guard<std::mutex> lock(doneMutex);
+    if (pending.fetch_sub(1) == 1) done.notify_all();
+}
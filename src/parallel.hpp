@@ -0,0 +1,123 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+
+// 0 = todos los núcleos disponibles
+inline int resolveThreadCount(int requested) {
+    if (requested > 0) return requested;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : static_cast<int>(hw);
+}
+
+class TaskGroup;
+
+// Planificador con robo de trabajo compartido por todo el proyecto: un pool fijo de
+// workers, cada uno con su deque. Un worker toma del final lo que él mismo encoló y,
+// sin trabajo propio, roba del principio de la cola de inyección (tareas de hilos
+// externos) y de los demás. Quien espera un TaskGroup ejecuta mientras tanto las
+// tareas de ese grupo (nunca otras: un parallelFor anidado no toma trabajo ajeno que
+// lo demore) y, si las que faltan ya las tomaron otros hilos, duerme hasta que terminan.
+class TaskScheduler {
+public:
+    // threads cuenta al hilo que espera: el pool tiene threads - 1 workers (0 = todos
+    // los núcleos). Con pinWorkers el hilo que llama queda en el primer núcleo de la
+    // máscara del proceso y cada worker en uno de los siguientes. Reemplaza el pool
+    // actual, así que no debe haber tareas en curso.
+    static void configure(int threads, bool pinWorkers = false);
+    static TaskScheduler& instance();  // el pool configurado, creado en el primer uso
+
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    int threads() const { return static_cast<int>(workers.size()) + 1; }
+    bool pinned() const { return pinWorkers; }
+
+private:
+    friend class TaskGroup;
+
+    struct Job {
+        std::function<void()> fn;
+        TaskGroup* group = nullptr;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    TaskScheduler(int threads, bool pinWorkers);
+    void push(Job job);
+    bool runOne(const TaskGroup* group = nullptr);  // ejecuta una tarea (del grupo, si se da) si encuentra alguna
+    bool take(size_t queue, bool newest, const TaskGroup* group, Job& job);
+    void workerLoop(size_t index, int cpu);
+
+    std::vector<std::unique_ptr<Queue>> queues;  // 0 = inyección, i = worker i
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queued{0};
+    bool stopping = false;
+    bool pinWorkers = false;
+};
+
+// Tareas con espera conjunta (fork-join). El destructor espera las pendientes.
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::instance()) : scheduler(scheduler) {}
+    ~TaskGroup();
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+    // Ejecuta tareas hasta que terminan las del grupo; relanza la primera excepción
+    void wait();
+
+private:
+    friend class TaskScheduler;
+    void finish(std::exception_ptr failure);
+    void drain();
+
+    TaskScheduler& scheduler;
+    std::atomic<size_t> pending{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    std::mutex doneMutex;  // finish avisa bajo este mutex cuando termina la última tarea
+    std::condition_variable done;
+};
+
+// Ejecuta fn(i) para i en [0, count) repartiendo los índices dinámicamente entre
+// numThreads hilos del planificador (el hilo llamador también trabaja). numThreads
+// se limita al tamaño del pool.
+template <typename Fn>
+void parallelFor(size_t count, int numThreads, Fn&& fn) {
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    size_t workers = std::min({static_cast<size_t>(std::max(numThreads, 1)),
+                               static_cast<size_t>(scheduler.threads()), count});
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; i++) fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+    };
+
+    TaskGroup group(scheduler);
+    for (size_t t = 1; t < workers; t++) group.run(work);
+    work();
+    group.wait();
+}
+
+#endif
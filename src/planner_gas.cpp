@@ -1,79 +1,131 @@
 #include "planner_gas.hpp"
 #include "utils.hpp"
+#include "shareability_graph.hpp"
+#include "combination_stream.hpp"
+#include "route_planner.hpp"
+#include "trace.hpp"
 #include <algorithm>
-#include <set>
+#include <functional>
 #include <iostream>
 
-void generateCombinations(const std::vector<Request>& requests,
-                          int k,
-                          std::vector<std::vector<Request>>& output,  //!combina todas las posibles agrupaciones de k solicitudes
-                          std::vector<Request> current = {},
-                          int index = 0) {
-    if (current.size() == k) {
-        output.push_back(current);
-        return;
-    }
-    for (size_t i = index; i < requests.size(); i++) {
-        current.push_back(requests[i]);
-        generateCombinations(requests, k, output, current, i + 1);
-        current.pop_back();
+namespace {
+
+// best[m * (n + 1) + i]: suma de los m mayores pagos sin asignar entre las posiciones
+// [i, n) de candidates, lo más que pueden aportar m requests más a un prefijo que
+// termina antes de i (las combinaciones avanzan en orden lexicográfico)
+std::vector<double> suffixBestPayments(const RequestCatalog& catalog, const std::vector<int>& candidates,
+                                       const std::vector<char>& assigned, int maxCount) {
+    const size_t n = candidates.size();
+    std::vector<double> best(static_cast<size_t>(maxCount + 1) * (n + 1), 0.0);
+    std::vector<double> top;  // mayores pagos vistos, de mayor a menor
+    for (size_t i = n; i-- > 0;) {
+        int r = candidates[i];
+        if (!assigned[r]) {
+            double p = catalog.payment[r];
+            top.insert(std::upper_bound(top.begin(), top.end(), p, std::greater<double>()), p);
+            if (top.size() > static_cast<size_t>(maxCount)) top.pop_back();
+        }
+        double sum = 0.0;
+        for (int m = 1; m <= maxCount; m++) {
+            if (m <= static_cast<int>(top.size())) sum += top[m - 1];
+            best[m * (n + 1) + i] = sum;
+        }
     }
+    return best;
 }
 
-bool isFeasible(const std::vector<Request>& group, const Vehicle& v) {
-    if (group.size() > (size_t)v.capacity) return false;
-    return calculateMinSlack(v, group) >= 1.0;  //slack mínimo requerido
 }
 
-void planRoutesGAS(std::vector<Request>& requests, std::vector<Vehicle>& vehicles) {
-    std::set<int> assignedRequests;
-    std::vector<std::vector<Request>> allGroups;
+// Enumeración exhaustiva de GAS sin materializar los grupos: para cada vehículo se
+// recorren las combinaciones de k requests (k creciente, orden lexicográfico) y se
+// poda un prefijo en cuanto contiene un request asignado, un par incompatible o un
+// request con slack < 1. La factibilidad es cerrada hacia abajo, así que la poda no
+// pierde grupos y el mejor grupo (el primero con mayor profit) es el mismo que con
+// la lista completa. Además se descarta un prefijo cuando ni completándolo con los
+// mayores pagos que quedan después de él alcanza al mejor grupo ya encontrado, antes
+// de pagar su verificación de slack. Con optimizeRouteOrder el prefijo vive en un
+// RoutePlanner, que reutiliza los estados del prefijo al cambiar el último request.
+void planRoutesGAS(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles, const PlannerOptions& options) {
+    std::vector<char> assigned(catalog.size(), 0);
+    std::unique_ptr<ShareabilityGraph> pairs = makeShareabilityGraph(catalog, options);
+    std::vector<int> candidates = catalog.allIndices();  // la posición de cada request es su índice
+    const size_t stride = candidates.size() + 1;
 
     int maxCap = 0;
     for (const auto& v : vehicles) {
         maxCap = std::max(maxCap, v.capacity);
     }
 
-    // Fase 1: Generar todos los grupos viables
-    for (int k = 1; k <= maxCap; k++) {
-        std::vector<std::vector<Request>> combinations;
-        generateCombinations(requests, k, combinations);
-        for (auto& group : combinations) {
-            allGroups.push_back(group);
-        }
-    }
-
-    // Fase 2: Asignación iterativa por vehículo
+    // Asignación iterativa por vehículo
     for (auto& v : vehicles) {
+        TRACE_SCOPE("gas.vehicle");
         double maxProfit = -1;
-        std::vector<Request> bestGroup;
+        std::vector<int> bestGroup;
 
-        for (auto& group : allGroups) {
-            bool valid = true;
-            for (auto& r : group) {
-                if (assignedRequests.count(r.id)) {
-                    valid = false;
-                    break;
+        int groupLimit = std::min(maxCap, v.capacity);
+        if (options.optimizeRouteOrder) groupLimit = std::min(groupLimit, RoutePlanner::MAX_REQUESTS);
+        std::vector<RouteState> route(groupLimit + 1);  // estado tras cada prefijo
+        std::vector<double> profit(groupLimit + 1, 0.0);
+        route[0] = startRoute(catalog, v);
+        RoutePlanner planner(catalog, v);
+        std::vector<double> bestSuffix = suffixBestPayments(catalog, candidates, assigned, groupLimit);
+
+        for (int k = 1; k <= groupLimit; k++) {
+            CombinationStream stream(candidates, k);
+            auto accept = [&](int depth, int r) {
+                if (assigned[r]) {
+                    TRACE_COUNT("gas.overlap_rejects", 1);
+                    return false;
                 }
-            }
-            if (!valid || !isFeasible(group, v)) continue;
+                // cota superior del profit de cualquier grupo con este prefijo, con margen
+                // para el redondeo: los empates exactos se siguen recorriendo
+                double reach = profit[depth] + catalog.payment[r] + bestSuffix[(k - depth - 1) * stride + r + 1];
+                if (reach < maxProfit - 1e-9) {
+                    TRACE_COUNT("gas.bound_rejects", 1);
+                    return false;
+                }
+                if (pairs && depth > 0 && !pairs->canAppend(stream.current().data(), depth, r)) return false;  // descarte por pares
 
-            double profit = 0;
-            for (auto& r : group) profit += r.payment;
-            if (profit > maxProfit) {
-                maxProfit = profit;
-                bestGroup = group;
+                TRACE_COUNT("slack.checks", 1);
+                if (options.optimizeRouteOrder) {
+                    planner.truncate(depth);
+                    if (!(depth + 1 == k ? planner.probe(r) : planner.push(r))) {  // el último sólo se prueba
+                        TRACE_COUNT("slack.rejects", 1);
+                        return false;
+                    }
+                } else {
+                    route[depth + 1] = route[depth];
+                    if (appendToRoute(route[depth + 1], catalog, r) < 1.0) {  //slack mínimo requerido
+                        TRACE_COUNT("slack.rejects", 1);
+                        return false;
+                    }
+                }
+                profit[depth + 1] = profit[depth] + catalog.payment[r];
+                return true;
+            };
+
+            while (stream.next(accept)) {
+                if (profit[k] > maxProfit) {
+                    maxProfit = profit[k];
+                    bestGroup = stream.current();
+                }
             }
         }
 
-        for (auto& r : bestGroup) {
-            v.assignedRequestIds.push_back(r.id);
-            assignedRequests.insert(r.id);
+        for (int r : bestGroup) {
+            v.assignedRequestIds.push_back(catalog.ids[r]);
+            assigned[r] = 1;
+        }
+        if (options.optimizeRouteOrder) {
+            planner.assign(bestGroup.data(), static_cast<int>(bestGroup.size()));
+            v.route = planner.route();
+        } else {
+            v.route = sequentialRoute(catalog, bestGroup);
         }
 
         if (!bestGroup.empty()) {
             std::cout << "Vehicle " << v.id << " assigned requests: ";
-            for (auto& r : bestGroup) std::cout << r.id << " ";
+            for (int r : bestGroup) std::cout << catalog.ids[r] << " ";
             std::cout << " | Total Payment: " << maxProfit << "\n";
         }
     }
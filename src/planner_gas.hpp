@@ -4,7 +4,10 @@
 #include <vector>
 #include "request.hpp"
 #include "vehicle.hpp"
+#include "request_catalog.hpp"
+#include "planner_options.hpp"
 
-void planRoutesGAS(std::vector<Request>& requests, std::vector<Vehicle>& vehicles);
+void planRoutesGAS(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles,
+                   const PlannerOptions& options = {});
 
 #endif
@@ -1,62 +1,61 @@
 #include "planner_gaso1.hpp"
 #include "additive_tree.hpp"
+#include "group_index.hpp"
+#include "shareability_graph.hpp"
+#include "route_planner.hpp"
 #include "utils.hpp"
-#include <set>
+#include "trace.hpp"
 #include <iostream>
 
-void planRoutesGASO1(std::vector<Request>& requests, std::vector<Vehicle>& vehicles) {
+void planRoutesGASO1(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles, const PlannerOptions& options) {
     int maxCap = 0;
     for (const auto& v : vehicles) {
         maxCap = std::max(maxCap, v.capacity);
     }
 
-    AdditiveTree tree(requests, maxCap);  //arbol global.
+    std::unique_ptr<ShareabilityGraph> pairs = makeShareabilityGraph(catalog, options);
+    TRACE_SCOPE("gaso1.plan");
+    AdditiveTree tree(catalog, maxCap, options, pairs.get());  //arbol global.
     //! debe ocupar la máxima capacidad que hay entre los vehiculos si va a ser arbol general
 
-    std::set<int> assignedRequestIds;
+    planRoutesGASO1(tree, vehicles, options);
+}
 
-    for (auto& vehicle : vehicles) {
-        TreeNode* best = nullptr;
-        double maxProfit = -1.0;
-
-        for (TreeNode* node : tree.getAllNodes()) {
-            if (node->requestIds.size() > (size_t)vehicle.capacity) continue;
-            
-            bool overlap = false; //verifica overlap entre asignaciones
-            std::vector<Request> group;
-            for (int id : node->requestIds) {
-                if (assignedRequestIds.count(id)) {
-                    overlap = true;
-                    break;
-                }
-                for (const auto& r : requests) {
-                    if (r.id == id) {
-                        group.push_back(r);
-                        break;
-                    }
-                }
-            }
-            if (overlap) continue;
-
-            if (calculateMinSlack(vehicle, group) < 1.0) continue;
+void planRoutesGASO1(const AdditiveTree& tree, std::vector<Vehicle>& vehicles, const PlannerOptions& options) {
+    const RequestCatalog& catalog = tree.catalog;
+    GroupIndex groups(tree);  // grupos por profit; los asignados se invalidan en O(grupos del request)
 
-            if (node->profit > maxProfit) {
-                maxProfit = node->profit;
-                best = node;
-            }
-        }
+    for (auto& vehicle : vehicles) {
+        TRACE_SCOPE("gaso1.scan");
+        RoutePlanner planner(catalog, vehicle);
+        std::vector<int> group;
+
+        // el primer grupo vivo y factible en orden de profit es el de mayor profit
+        const TreeNode* best = groups.findFirst([&](const TreeNode& node) {
+            TRACE_COUNT("gaso1.nodes_scanned", 1);
+            if (node.requestIds.size() > (size_t)vehicle.capacity) return false;
+
+            group.clear();
+            for (int id : node.requestIds) group.push_back(catalog.indexOf(id));
+            TRACE_COUNT("slack.checks", 1);
+            bool feasible = options.optimizeRouteOrder ? planner.assign(group.data(), static_cast<int>(group.size()))
+                                                       : calculateMinSlack(vehicle, catalog, group) >= 1.0;
+            if (!feasible) TRACE_COUNT("slack.rejects", 1);
+            return feasible;
+        });
 
         if (best) {
             for (int id : best->requestIds) {
-                assignedRequestIds.insert(id);
                 vehicle.assignedRequestIds.push_back(id);
+                groups.retire(id);
             }
+            vehicle.route = options.optimizeRouteOrder ? planner.route() : sequentialRoute(catalog, group);
 
             std::cout << "Vehicle " << vehicle.id << " assigned requests: ";
             for (int id : best->requestIds){
                 std::cout << id << " ";
             } 
-            std::cout << "| Total Payment: " << maxProfit << "\n";
+            std::cout << "| Total Payment: " << best->profit << "\n";
         }
     }
 }
\ No newline at end of file
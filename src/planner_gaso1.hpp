@@ -4,7 +4,17 @@
 #include <vector>
 #include "request.hpp"
 #include "vehicle.hpp"
+#include "request_catalog.hpp"
+#include "planner_options.hpp"
 
-void planRoutesGASO1(std::vector<Request>& requests, std::vector<Vehicle>& vehicles);
+class AdditiveTree;
+
+void planRoutesGASO1(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles,
+                     const PlannerOptions& options = {});
+
+// Con un árbol global ya construido (p. ej. mantenido con insert/retire entre rondas);
+// el llamador retira del árbol los requests asignados
+void planRoutesGASO1(const AdditiveTree& tree, std::vector<Vehicle>& vehicles,
+                     const PlannerOptions& options = {});
 
 #endif
@@ -1,83 +1,239 @@
 #include "planner_gaso2.hpp"
 #include "additive_tree.hpp"
+#include "parallel.hpp"
+#include "spatial_grid.hpp"
+#include "shareability_graph.hpp"
+#include "route_planner.hpp"
 #include "utils.hpp"
+#include "trace.hpp"
 #include <iostream>
 #include <random>
 #include <set>
 #include <algorithm>
+#include <memory>
+#include <limits>
 
-std::vector<Request> filterFeasibleRequests(const Vehicle& v, const std::vector<Request>& requests) {
-    std::vector<Request> result;
-    for (const auto& r : requests) {
-        double distance = euclideanDistance(v.location, r.origin);
-        if (distance <= (r.deadline - r.releaseTime)) {
+std::vector<int> filterFeasibleRequests(const Vehicle& v, const RequestCatalog& catalog, const std::vector<int>& candidates) {
+    std::vector<int> result;
+    int node = catalog.travel.snap(v.location.first, v.location.second);
+    for (int r : candidates) {
+        double distance = catalog.timeFrom(v.location.first, v.location.second, node, r);
+        if (distance <= (catalog.deadline[r] - catalog.releaseTime[r])) {
             result.push_back(r);
         }
     }
     return result;
 }
 
-void planRoutesGASO2(std::vector<Request>& requests, std::vector<Vehicle>& vehicles) {
-    std::set<int> assignedRequestIds;
-    std::random_device rd; //orden aleatorio de vehiculos
-    std::mt19937 g(rd());
-    std::shuffle(vehicles.begin(), vehicles.end(), g);
+namespace {
 
-    for (auto& vehicle : vehicles) {
-        std::vector<Request> unassigned;
-        for (const auto& r : requests) {
-            if (assignedRequestIds.count(r.id) == 0) {
-                unassigned.push_back(r);
-            }
+struct RankedGroup {
+    double profit;
+    size_t rank;           // orden de visita en el recorrido del árbol (desempate)
+    std::vector<int> ids;
+};
+
+// Grupos factibles del árbol local de un vehículo, de mayor a menor profit
+struct VehicleCandidates {
+    std::vector<int> feasible;        // índices que pasan filterFeasibleRequests
+    std::vector<RankedGroup> groups;
+    bool truncated = false;           // había más grupos factibles que los guardados
+};
+
+bool overlaps(const std::vector<int>& ids, const std::set<int>& assigned) {
+    for (int id : ids) {
+        if (assigned.count(id)) return true;
+    }
+    return false;
+}
+
+std::vector<int> unassignedRequests(const RequestCatalog& catalog, const std::set<int>& assigned) {
+    std::vector<int> unassigned;
+    for (size_t r = 0; r < catalog.size(); r++) {
+        if (assigned.count(catalog.ids[r]) == 0) {
+            unassigned.push_back(static_cast<int>(r));
         }
+    }
+    return unassigned;
+}
 
-        std::vector<Request> feasible = filterFeasibleRequests(vehicle, unassigned);
-        if (feasible.empty()) continue;
+// Requests sin asignar alcanzables por el vehículo; la grilla (si existe) ya no
+// contiene los asignados y evita recorrer todos los requests
+std::vector<int> reachableRequests(const Vehicle& vehicle, const RequestCatalog& catalog,
+                                   const SpatialGrid* grid, const std::set<int>& assigned) {
+    TRACE_SCOPE("gaso2.reachable");
+    if (grid) return grid->reachableFrom(vehicle.location.first, vehicle.location.second);
+    return filterFeasibleRequests(vehicle, catalog, unassignedRequests(catalog, assigned));
+}
+
+// Construye el árbol local sobre feasible y conserva los `limit` mejores grupos que no
+// se solapan con assigned. Entre grupos de igual profit gana el primero del recorrido.
+VehicleCandidates rankCandidates(const Vehicle& vehicle, const RequestCatalog& catalog,
+                                 std::vector<int> feasible, const std::set<int>& assigned,
+                                 size_t limit, const PlannerOptions& treeOptions,
+                                 const ShareabilityGraph* pairs) {
+    TRACE_SCOPE("gaso2.rank_candidates");
+    VehicleCandidates result;
+    result.feasible = std::move(feasible);
+    if (result.feasible.empty()) return result;
+
+    AdditiveTree localTree(catalog, result.feasible, vehicle.capacity, vehicle, treeOptions, pairs); //construir add.tree solo con estas solicitudes
 
-        AdditiveTree localTree(feasible, vehicle.capacity, vehicle); //construir add.tree solo con estas solicitudes
+    // Los niveles >= 2 ya pasaron la restricción de slack con este vehículo al construir
+    // el árbol; el nivel 1 trae su slack en el resumen de ruta
+    const std::vector<double>& singleSlack = localTree.levels[1].minSlack;
 
-        TreeNode* best = nullptr;
-        double maxProfit = -1;
+    // Los `limit` mejores grupos en un heap con el peor arriba. Con el heap lleno se
+    // salta todo subárbol cuyo mayor profit no supera al peor guardado: sus nodos vienen
+    // después en el recorrido, así que no entrarían ni empatando.
+    struct Ranked {
+        TreeNode node;
+        size_t rank;
+    };
+    auto better = [](const Ranked& a, const Ranked& b) {
+        if (a.node.profit != b.node.profit) return a.node.profit > b.node.profit;
+        return a.rank < b.rank;
+    };
+    std::vector<Ranked> heap;
+    auto bound = [&] {
+        if (heap.size() < limit) return -std::numeric_limits<double>::infinity();
+        return limit ? heap.front().node.profit : std::numeric_limits<double>::infinity();
+    };
 
-        for (TreeNode* node : localTree.getAllNodes()) {
-            if (node->requestIds.size() > (size_t)vehicle.capacity) continue;
+    TRACE_SCOPE("gaso2.node_scan");
+    size_t rank = 0;
+    bool dropped = false;
+    size_t pruned = localTree.forEachNodeAbove(bound, [&](const TreeNode& node) {
+        TRACE_COUNT("gaso2.nodes_scanned", 1);
+        Ranked candidate{node, rank++};
+        if (node.requestIds.size() > (size_t)vehicle.capacity) return false;
 
-            bool overlap = false;
-            for (int id : node->requestIds) {
-                if (assignedRequestIds.count(id)) {
-                    overlap = true;
-                    break;
-                }
+        TRACE_COUNT("gaso2.overlap_checks", 1);
+        for (int id : node.requestIds) {
+            if (assigned.count(id)) {
+                TRACE_COUNT("gaso2.overlap_rejects", 1);
+                return false;  // los hijos contienen el mismo request
             }
-            if (overlap) continue;
-
-            std::vector<Request> group;
-            for (int id : node->requestIds) {
-                for (const auto& r : requests) {
-                    if (r.id == id) {
-                        group.push_back(r);
-                        break;
-                    }
-                }
+        }
+
+        if (node.level == 1 && singleSlack[node.index] < 1.0) return true; // restriccion de min slack time
+        if (heap.size() < limit) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else {
+            dropped = true;
+            if (better(candidate, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), better);
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end(), better);
             }
+        }
+        return true;
+    });
+    TRACE_COUNT("gaso2.subtrees_pruned", pruned);
+    result.truncated = dropped || pruned > 0;  // cota conservadora: sólo fuerza un recálculo
+
+    std::sort_heap(heap.begin(), heap.end(), better);
+    for (const Ranked& r : heap) {
+        result.groups.push_back({r.node.profit, r.rank, {r.node.requestIds.begin(), r.node.requestIds.end()}});
+    }
+    return result;
+}
+
+void assignGroup(Vehicle& vehicle, const RankedGroup& best, const RequestCatalog& catalog,
+                 std::set<int>& assignedRequestIds, SpatialGrid* grid, const PlannerOptions& options) {
+    TRACE_SCOPE("gaso2.assign");
+    std::vector<int> group;
+    for (int id : best.ids) {
+        assignedRequestIds.insert(id);
+        vehicle.assignedRequestIds.push_back(id);
+        group.push_back(catalog.indexOf(id));
+        if (grid) grid->remove(group.back());
+    }
+    if (options.optimizeRouteOrder) {
+        RoutePlanner planner(catalog, vehicle);
+        planner.assign(group.data(), static_cast<int>(group.size()));
+        vehicle.route = planner.route();
+    } else {
+        vehicle.route = sequentialRoute(catalog, group);
+    }
+
+    std::cout << "Vehicle " << vehicle.id << " assigned requests: ";
+    for (int id : best.ids) std::cout << id << " ";
+    std::cout << "| Total Payment: " << best.profit << "\n";
+}
+
+// Fase 1 en paralelo: cada vehículo arma su árbol local contra todos los requests.
+// Fase 2 secuencial (en el orden aleatorio): se toma el mejor candidato que no choque
+// con lo ya asignado. Como los grupos de un subconjunto de requests son exactamente
+// los grupos del árbol completo que no los tocan, el resultado coincide con el modo
+// serial; si se agotan los candidatos guardados se recalcula ese vehículo.
+void planParallel(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles, const PlannerOptions& options) {
+    std::set<int> assignedRequestIds;
+    std::unique_ptr<SpatialGrid> grid;
+    if (options.spatialIndex && catalog.travel.boundedByEuclidean()) grid = std::make_unique<SpatialGrid>(catalog, catalog.allIndices());
+    std::unique_ptr<ShareabilityGraph> pairs = makeShareabilityGraph(catalog, options);  // compartida por todos los árboles locales
 
-            if (calculateMinSlack(vehicle, group) < 1.0) continue; // restriccion de min slack time
+    PlannerOptions treeOptions = options;
+    treeOptions.numThreads = 1;  // el paralelismo es entre vehículos
 
-            if (node->profit > maxProfit) {
-                maxProfit = node->profit;
-                best = node;
+    std::vector<VehicleCandidates> candidates(vehicles.size());
+    parallelFor(vehicles.size(), resolveThreadCount(options.numThreads), [&](size_t v) {
+        candidates[v] = rankCandidates(vehicles[v], catalog, reachableRequests(vehicles[v], catalog, grid.get(), {}),
+                                       {}, options.candidatesPerVehicle, treeOptions, pairs.get());
+    });
+
+    for (size_t v = 0; v < vehicles.size(); v++) {
+        VehicleCandidates& mine = candidates[v];
+        bool anyLeft = false;
+        for (int r : mine.feasible) {
+            if (!assignedRequestIds.count(catalog.ids[r])) {
+                anyLeft = true;
+                break;
             }
         }
+        if (!anyLeft) continue;
 
-        if (best) {
-            for (int id : best->requestIds) {
-                assignedRequestIds.insert(id);
-                vehicle.assignedRequestIds.push_back(id);
+        const RankedGroup* best = nullptr;
+        for (const auto& group : mine.groups) {
+            if (!overlaps(group.ids, assignedRequestIds)) {
+                best = &group;
+                break;
             }
+        }
+
+        if (!best && mine.truncated) {  // conflicto en todos los candidatos: recalcular
+            mine = rankCandidates(vehicles[v], catalog, reachableRequests(vehicles[v], catalog, grid.get(), assignedRequestIds),
+                                  assignedRequestIds, 1, treeOptions, pairs.get());
+            if (!mine.groups.empty()) best = &mine.groups[0];
+        }
+
+        if (best) assignGroup(vehicles[v], *best, catalog, assignedRequestIds, grid.get(), options);
+    }
+}
+
+}
+
+void planRoutesGASO2(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles, const PlannerOptions& options) {
+    //orden aleatorio de vehiculos
+    std::mt19937 g(options.shuffleSeed ? options.shuffleSeed : std::random_device{}());
+    std::shuffle(vehicles.begin(), vehicles.end(), g);
 
-            std::cout << "Vehicle " << vehicle.id << " assigned requests: ";
-            for (int id : best->requestIds) std::cout << id << " ";
-            std::cout << "| Total Payment: " << maxProfit << "\n";
+    if (options.parallelVehicles) {
+        planParallel(catalog, vehicles, options);
+        return;
+    }
+
+    std::set<int> assignedRequestIds;
+    std::unique_ptr<SpatialGrid> grid;
+    if (options.spatialIndex && catalog.travel.boundedByEuclidean()) grid = std::make_unique<SpatialGrid>(catalog, catalog.allIndices());
+    std::unique_ptr<ShareabilityGraph> pairs = makeShareabilityGraph(catalog, options);  // compartida por todos los árboles locales
+
+    for (auto& vehicle : vehicles) {
+        VehicleCandidates best = rankCandidates(vehicle, catalog, reachableRequests(vehicle, catalog, grid.get(), assignedRequestIds),
+                                                assignedRequestIds, 1, options, pairs.get());
+        if (!best.groups.empty()) {
+            assignGroup(vehicle, best.groups[0], catalog, assignedRequestIds, grid.get(), options);
         }
     }
 }
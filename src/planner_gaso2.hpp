@@ -4,7 +4,14 @@
 #include <vector>
 #include "request.hpp"
 #include "vehicle.hpp"
+#include "request_catalog.hpp"
+#include "planner_options.hpp"
 
-void planRoutesGASO2(std::vector<Request>& requests, std::vector<Vehicle>& vehicles);
+void planRoutesGASO2(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles,
+                     const PlannerOptions& options = {});
+
+// Candidatos (índices del catálogo) cuyo origen está a distancia <= deadline - releaseTime
+// de la posición de v
+std::vector<int> filterFeasibleRequests(const Vehicle& v, const RequestCatalog& catalog, const std::vector<int>& candidates);
 
 #endif
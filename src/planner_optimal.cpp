@@ -0,0 +1,231 @@
+#include "planner_optimal.hpp"
+#include "additive_tree.hpp"
+#include "shareability_graph.hpp"
+#include "route_planner.hpp"
+#include "utils.hpp"
+#include "trace.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+struct Candidate {
+    const TreeNode* node;
+    std::vector<int> members;  // índices del catálogo
+};
+
+// Grupos factibles de cada vehículo, de mayor a menor profit
+struct VehicleCandidates {
+    std::vector<Candidate> groups;
+};
+
+bool overlaps(const Candidate& c, const std::vector<char>& used) {
+    for (int r : c.members) {
+        if (used[r]) return true;
+    }
+    return false;
+}
+
+class AssignmentSearch {
+public:
+    AssignmentSearch(const RequestCatalog& catalog, const std::vector<VehicleCandidates>& candidates,
+                     double timeLimitMs, PlannerStats* stats)
+        : catalog(catalog), candidates(candidates), used(catalog.size(), 0), choice(candidates.size(), -1),
+          deadline(std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                       std::chrono::duration<double, std::milli>(timeLimitMs))),
+          stats(stats) {
+        // primero los vehículos con mejores grupos: la cota se ajusta antes
+        order.resize(candidates.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return topProfit(a) > topProfit(b);
+        });
+
+        std::vector<char> seen(catalog.size(), 0);
+        seats.assign(candidates.size(), 0);
+        for (size_t v = 0; v < candidates.size(); v++) {
+            for (const Candidate& c : candidates[v].groups) {
+                seats[v] = std::max(seats[v], static_cast<int>(c.members.size()));
+                for (int r : c.members) {
+                    if (!seen[r]) pool.push_back(r);
+                    seen[r] = 1;
+                }
+            }
+        }
+        std::stable_sort(pool.begin(), pool.end(),
+                         [&](int a, int b) { return catalog.payment[a] > catalog.payment[b]; });
+    }
+
+    // incumbent: elección inicial (posición en la lista de cada vehículo o -1)
+    std::vector<int> solve(std::vector<int> incumbent, double incumbentProfit) {
+        best = std::move(incumbent);
+        bestProfit = incumbentProfit;
+        search(0, 0.0);
+        if (stats) {
+            stats->searchNodes.fetch_add(nodes, std::memory_order_relaxed);
+            if (timedOut) stats->searchTimeouts.fetch_add(1, std::memory_order_relaxed);
+        }
+        return best;
+    }
+
+private:
+    static constexpr double EPS = 1e-9;
+
+    const RequestCatalog& catalog;
+    const std::vector<VehicleCandidates>& candidates;
+    std::vector<size_t> order;
+    std::vector<int> seats;  // tamaño del mayor grupo candidato de cada vehículo
+    std::vector<int> pool;   // requests de algún candidato, de mayor a menor pago
+    std::vector<char> used;
+    std::vector<int> choice;
+    std::vector<int> best;
+    double bestProfit = 0.0;
+    std::chrono::steady_clock::time_point deadline;
+    PlannerStats* stats;
+    uint64_t nodes = 0;
+    bool timedOut = false;
+
+    double topProfit(size_t v) const {
+        return candidates[v].groups.empty() ? 0.0 : candidates[v].groups[0].node->profit;
+    }
+
+    // Cota superior, la menor de dos relajaciones: cada vehículo restante toma su mejor
+    // grupo libre ignorando los conflictos entre ellos, o los asientos restantes se
+    // llenan con los requests libres mejor pagados
+    double bound(size_t depth) const {
+        double byVehicle = 0.0;
+        int freeSeats = 0;
+        for (size_t i = depth; i < order.size(); i++) {
+            freeSeats += seats[order[i]];
+            for (const Candidate& c : candidates[order[i]].groups) {
+                if (!overlaps(c, used)) {
+                    byVehicle += c.node->profit;
+                    break;
+                }
+            }
+        }
+        double byRequest = 0.0;
+        for (size_t k = 0; k < pool.size() && freeSeats > 0; k++) {
+            if (used[pool[k]]) continue;
+            byRequest += catalog.payment[pool[k]];
+            freeSeats--;
+        }
+        return std::min(byVehicle, byRequest);
+    }
+
+    void search(size_t depth, double profit) {
+        if (timedOut) return;
+        if (++nodes % 1024 == 0 && std::chrono::steady_clock::now() > deadline) {
+            timedOut = true;
+            return;
+        }
+        if (depth == order.size()) {
+            if (profit > bestProfit + EPS) {
+                bestProfit = profit;
+                best = choice;
+            }
+            return;
+        }
+        if (profit + bound(depth) <= bestProfit + EPS) return;
+
+        size_t v = order[depth];
+        const auto& groups = candidates[v].groups;
+        for (size_t g = 0; g < groups.size() && !timedOut; g++) {
+            if (overlaps(groups[g], used)) continue;
+            for (int r : groups[g].members) used[r] = 1;
+            choice[v] = static_cast<int>(g);
+            search(depth + 1, profit + groups[g].node->profit);
+            for (int r : groups[g].members) used[r] = 0;
+        }
+        choice[v] = -1;  // el vehículo queda libre
+        search(depth + 1, profit);
+    }
+};
+
+}
+
+void planRoutesOptimal(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles, const PlannerOptions& options) {
+    int maxCap = 0;
+    for (const auto& v : vehicles) {
+        maxCap = std::max(maxCap, v.capacity);
+    }
+
+    std::unique_ptr<ShareabilityGraph> pairs = makeShareabilityGraph(catalog, options);
+    AdditiveTree tree(catalog, maxCap, options, pairs.get());
+    std::vector<TreeNode> ordered = tree.getAllNodes();  // mismo orden que GroupIndex
+    // sin la raíz: el grupo vacío ya es la opción "vehículo libre" de la búsqueda
+    ordered.erase(std::remove_if(ordered.begin(), ordered.end(), [](const TreeNode& n) { return n.level == 0; }),
+                  ordered.end());
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const TreeNode& a, const TreeNode& b) { return a.profit > b.profit; });
+
+    // Grafo vehículo x grupo. La asignación greedy (la de GAS-O1) se arma a la vez: si
+    // la lista truncada de un vehículo ya está ocupada se sigue buscando en el resto, y
+    // ese grupo se agrega a su lista para que la búsqueda pueda conservarlo.
+    std::vector<VehicleCandidates> candidates(vehicles.size());
+    std::vector<char> used(catalog.size(), 0);
+    std::vector<int> greedy(vehicles.size(), -1);
+    double greedyProfit = 0.0;
+    {
+        TRACE_SCOPE("optimal.candidates");
+        for (size_t v = 0; v < vehicles.size(); v++) {
+            const Vehicle& vehicle = vehicles[v];
+            RoutePlanner planner(catalog, vehicle);
+            auto feasible = [&](const TreeNode& node, std::vector<int>& members) {
+                if (node.requestIds.size() > (size_t)vehicle.capacity) return false;
+                members.clear();
+                for (int id : node.requestIds) members.push_back(catalog.indexOf(id));
+                if (options.optimizeRouteOrder) return planner.assign(members.data(), static_cast<int>(members.size()));
+                return calculateMinSlack(vehicle, catalog, members) >= 1.0;
+            };
+
+            auto& groups = candidates[v].groups;
+            std::vector<int> members;
+            size_t pos = 0;
+            for (; pos < ordered.size() && groups.size() < options.assignmentCandidates; pos++) {
+                if (!feasible(ordered[pos], members)) continue;
+                groups.push_back({&ordered[pos], members});
+                if (greedy[v] < 0 && !overlaps(groups.back(), used)) greedy[v] = static_cast<int>(groups.size()) - 1;
+            }
+            for (; greedy[v] < 0 && pos < ordered.size(); pos++) {
+                if (!feasible(ordered[pos], members)) continue;
+                Candidate c{&ordered[pos], members};
+                if (overlaps(c, used)) continue;
+                groups.push_back(std::move(c));
+                greedy[v] = static_cast<int>(groups.size()) - 1;
+            }
+            if (greedy[v] >= 0) {
+                for (int r : groups[greedy[v]].members) used[r] = 1;
+                greedyProfit += groups[greedy[v]].node->profit;
+            }
+        }
+    }
+
+    std::vector<int> choice;
+    {
+        TRACE_SCOPE("optimal.search");
+        AssignmentSearch search(catalog, candidates, options.assignmentTimeLimitMs, options.stats);
+        choice = search.solve(greedy, greedyProfit);
+    }
+
+    for (size_t v = 0; v < vehicles.size(); v++) {
+        if (choice[v] < 0) continue;
+        Vehicle& vehicle = vehicles[v];
+        const Candidate& best = candidates[v].groups[choice[v]];
+        for (int id : best.node->requestIds) vehicle.assignedRequestIds.push_back(id);
+        if (options.optimizeRouteOrder) {
+            RoutePlanner planner(catalog, vehicle);
+            planner.assign(best.members.data(), static_cast<int>(best.members.size()));
+            vehicle.route = planner.route();
+        } else {
+            vehicle.route = sequentialRoute(catalog, best.members);
+        }
+
+        std::cout << "Vehicle " << vehicle.id << " assigned requests: ";
+        for (int id : best.node->requestIds) std::cout << id << " ";
+        std::cout << "| Total Payment: " << best.node->profit << "\n";
+    }
+}
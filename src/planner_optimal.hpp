@@ -0,0 +1,19 @@
+#ifndef PLANNER_OPTIMAL_HPP
+#define PLANNER_OPTIMAL_HPP
+
+#include <vector>
+#include "request.hpp"
+#include "vehicle.hpp"
+#include "request_catalog.hpp"
+#include "planner_options.hpp"
+
+// GAS-OPT: asignación conjunta en vez de vehículo por vehículo. Con los grupos del
+// árbol aditivo global arma el grafo vehículo x grupo factible (los
+// options.assignmentCandidates grupos de mayor profit de cada vehículo) y busca por
+// branch-and-bound el conjunto de pares con grupos disjuntos de mayor revenue total.
+// Parte de la asignación greedy de GAS-O1, así que nunca rinde menos; si la búsqueda
+// supera options.assignmentTimeLimitMs devuelve la mejor encontrada hasta entonces.
+void planRoutesOptimal(const RequestCatalog& catalog, std::vector<Vehicle>& vehicles,
+                       const PlannerOptions& options = {});
+
+#endif
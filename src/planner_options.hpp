@@ -0,0 +1,55 @@
+#ifndef PLANNER_OPTIONS_HPP
+#define PLANNER_OPTIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+// Contadores que los planners acumulan durante una ejecución (thread-safe)
+struct PlannerStats {
+    std::atomic<uint64_t> pairChecks{0};   // grupos evaluados contra la matriz de pares
+    std::atomic<uint64_t> pairRejects{0};  // grupos descartados sin simular la ruta
+    std::atomic<uint64_t> searchNodes{0};     // GAS-OPT: nodos del branch-and-bound
+    std::atomic<uint64_t> searchTimeouts{0};  // GAS-OPT: búsquedas cortadas por tiempo
+
+    void reset() {
+        pairChecks = 0;
+        pairRejects = 0;
+        searchNodes = 0;
+        searchTimeouts = 0;
+    }
+};
+
+// Parámetros de ejecución comunes a los planners
+struct PlannerOptions {
+    int numThreads = 1;  // hilos para construir el árbol aditivo (1 = serial, 0 = todos)
+
+    // GAS-O2: evaluar todos los vehículos en paralelo y resolver conflictos al asignar
+    bool parallelVehicles = false;
+    size_t candidatesPerVehicle = 16;  // grupos guardados por vehículo en modo paralelo
+
+    // Grilla sobre los orígenes: filtro de GAS-O2 y pares candidatos del árbol (exacto;
+    // se omite si la métrica del catálogo es una tabla de tiempos)
+    bool spatialIndex = true;
+
+    // Matriz de compatibilidad de pares por ronda (ShareabilityGraph), consultada
+    // antes de simular rutas; se omite si hay más de ShareabilityGraph::MAX_REQUESTS
+    bool pairGraph = true;
+
+    // Elegir el orden de recogidas y entregas de cada grupo (RoutePlanner) en vez de
+    // atender los requests uno tras otro; acepta más grupos y la matriz de pares pasa
+    // a admitir cualquier orden
+    bool optimizeRouteOrder = false;
+
+    // GAS-OPT: grupos factibles por vehículo que entran en la búsqueda y tiempo máximo
+    // de la búsqueda (al vencer queda la mejor asignación encontrada)
+    size_t assignmentCandidates = 32;
+    double assignmentTimeLimitMs = 200.0;
+
+    // GAS-O2: semilla del orden aleatorio de vehículos (0 = random_device, no reproducible)
+    unsigned shuffleSeed = 0;
+
+    PlannerStats* stats = nullptr;  // opcional: contadores de la ejecución
+};
+
+#endif
@@ -0,0 +1,233 @@
+#ifndef REQUEST_CATALOG_HPP
+#define REQUEST_CATALOG_HPP
+
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+#include "request.hpp"
+#include "travel_oracle.hpp"
+
+// Catálogo de requests compartido por el árbol y los planners. add agrega al final sin
+// cambiar los índices ya entregados; compact quita filas y renumera las que quedan (los
+// ids no cambian). Los datos se guardan por columnas (SoA) y se accede por índice denso;
+// indexOf traduce un id a su índice en O(1) (tabla densa o, con ids dispersos, hash).
+// Los tiempos de viaje salen de la métrica del catálogo; el viaje propio de cada
+// request queda precalculado.
+class RequestCatalog {
+public:
+    std::vector<int> ids;
+    std::vector<double> originX, originY;
+    std::vector<double> destX, destY;
+    std::vector<int> releaseTime;
+    std::vector<int> deadline;
+    std::vector<double> payment;
+    std::vector<double> tripTime;             // origen -> destino de cada request
+    std::vector<int> originNode, destNode;    // puntos de la tabla (sólo con métrica Table)
+    TravelOracle travel;
+
+    RequestCatalog() = default;
+
+    explicit RequestCatalog(const std::vector<Request>& requests, TravelOracle travel = {})
+        : travel(std::move(travel)) {
+        reserve(requests.size());
+        for (const auto& r : requests) add(r);
+    }
+
+    void reserve(size_t n) {
+        ids.reserve(n);
+        originX.reserve(n); originY.reserve(n);
+        destX.reserve(n); destY.reserve(n);
+        releaseTime.reserve(n); deadline.reserve(n); payment.reserve(n);
+        tripTime.reserve(n);
+    }
+
+    // Agrega un request al final y devuelve su índice
+    int add(const Request& r) {
+        if (r.id < 0) throw std::invalid_argument("RequestCatalog: negative request id");
+        if (indexOf(r.id) != -1) throw std::invalid_argument("RequestCatalog: duplicate request id");
+        const int index = static_cast<int>(ids.size());
+        ids.push_back(r.id);
+        indexId(r.id, index);
+        originX.push_back(r.origin.first);
+        originY.push_back(r.origin.second);
+        destX.push_back(r.destination.first);
+        destY.push_back(r.destination.second);
+        releaseTime.push_back(r.releaseTime);
+        deadline.push_back(r.deadline);
+        payment.push_back(r.payment);
+        tripTime.push_back(travel.between(r.origin.first, r.origin.second, r.destination.first, r.destination.second));
+        if (travel.metric() == TravelMetric::Table) {
+            originNode.push_back(travel.snap(r.origin.first, r.origin.second));
+            destNode.push_back(travel.snap(r.destination.first, r.destination.second));
+        }
+        return index;
+    }
+
+    // Carga en bloque: appendRows agrega n filas para que el llamador llene directamente
+    // las columnas de entrada (ids ... payment) y devuelve la primera; commitRows indexa
+    // las filas desde first y calcula sus tiempos de viaje. Si algún id es inválido o se
+    // repite, descarta esas filas y lanza std::invalid_argument.
+    size_t appendRows(size_t n) {
+        size_t first = ids.size();
+        ids.resize(first + n);
+        originX.resize(first + n); originY.resize(first + n);
+        destX.resize(first + n); destY.resize(first + n);
+        releaseTime.resize(first + n); deadline.resize(first + n); payment.resize(first + n);
+        return first;
+    }
+
+    void commitRows(size_t first) {
+        auto discard = [&](size_t marked, const char* reason) {
+            for (size_t i = first; i < marked; i++) unindexId(ids[i]);
+            ids.resize(first);
+            originX.resize(first); originY.resize(first);
+            destX.resize(first); destY.resize(first);
+            releaseTime.resize(first); deadline.resize(first); payment.resize(first);
+            throw std::invalid_argument(reason);
+        };
+        for (size_t i = first; i < ids.size(); i++) {
+            if (ids[i] < 0) discard(first, "RequestCatalog: negative request id");
+        }
+        for (size_t i = first; i < ids.size(); i++) {
+            if (indexOf(ids[i]) != -1) discard(i, "RequestCatalog: duplicate request id");
+            indexId(ids[i], static_cast<int>(i));
+        }
+
+        tripTime.resize(ids.size());
+        for (size_t i = first; i < ids.size(); i++) {
+            tripTime[i] = travel.between(originX[i], originY[i], destX[i], destY[i]);
+        }
+        if (travel.metric() == TravelMetric::Table) {
+            for (size_t i = first; i < ids.size(); i++) {
+                originNode.push_back(travel.snap(originX[i], originY[i]));
+                destNode.push_back(travel.snap(destX[i], destY[i]));
+            }
+        }
+    }
+
+    // Quita las filas con keep[i] == 0 conservando el orden de las demás y devuelve el
+    // índice nuevo de cada fila (-1 = quitada). El índice por id se rehace desde el menor
+    // id que queda, así que no crece con un stream de ids siempre mayores.
+    std::vector<int> compact(const std::vector<char>& keep) {
+        std::vector<int> map(ids.size(), -1);
+        const bool nodes = travel.metric() == TravelMetric::Table;
+        size_t w = 0;
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (!keep[i]) continue;
+            map[i] = static_cast<int>(w);
+            ids[w] = ids[i];
+            originX[w] = originX[i]; originY[w] = originY[i];
+            destX[w] = destX[i]; destY[w] = destY[i];
+            releaseTime[w] = releaseTime[i]; deadline[w] = deadline[i]; payment[w] = payment[i];
+            tripTime[w] = tripTime[i];
+            if (nodes) {
+                originNode[w] = originNode[i];
+                destNode[w] = destNode[i];
+            }
+            w++;
+        }
+        ids.resize(w);
+        originX.resize(w); originY.resize(w);
+        destX.resize(w); destY.resize(w);
+        releaseTime.resize(w); deadline.resize(w); payment.resize(w);
+        tripTime.resize(w);
+        if (nodes) {
+            originNode.resize(w);
+            destNode.resize(w);
+        }
+
+        indexById.clear();
+        sparseIndex.clear();
+        idBase = w > 0 ? *std::min_element(ids.begin(), ids.end()) : 0;
+        for (size_t i = 0; i < w; i++) indexId(ids[i], static_cast<int>(i));
+        return map;
+    }
+
+    // Corre el origen del tiempo delta segundos hacia adelante: releaseTime y deadline
+    // quedan relativos al nuevo instante 0 (donde arrancan los vehículos)
+    void shiftTimes(int delta) {
+        if (delta == 0) return;
+        for (auto& t : releaseTime) t -= delta;
+        for (auto& t : deadline) t -= delta;
+    }
+
+    size_t size() const { return ids.size(); }
+
+    // -1 si el id no está en el catálogo
+    int indexOf(int id) const {
+        const size_t slot = slotOf(id);
+        if (slot < indexById.size() && indexById[slot] != -1) return indexById[slot];
+        if (sparseIndex.empty()) return -1;
+        auto it = sparseIndex.find(id);
+        return it == sparseIndex.end() ? -1 : it->second;
+    }
+
+    // Del destino de a al origen de b
+    double legTime(int a, int b) const {
+        if (travel.metric() == TravelMetric::Table) return travel.betweenNodes(destNode[a], originNode[b]);
+        return travel.between(destX[a], destY[a], originX[b], originY[b]);
+    }
+
+    // De (x, y) al origen de r; node es snap(x, y), calculado una vez por el llamador
+    double timeFrom(double x, double y, int node, int r) const {
+        if (travel.metric() == TravelMetric::Table) return travel.betweenNodes(node, originNode[r]);
+        return travel.between(x, y, originX[r], originY[r]);
+    }
+
+    // Paradas: 2 * r recoge el request r y 2 * r + 1 lo deja
+    double stopTime(int from, int to) const {
+        if (travel.metric() == TravelMetric::Table) return travel.betweenNodes(stopNode(from), stopNode(to));
+        return travel.between(stopX(from), stopY(from), stopX(to), stopY(to));
+    }
+
+    double timeToStop(double x, double y, int node, int stop) const {
+        if (travel.metric() == TravelMetric::Table) return travel.betweenNodes(node, stopNode(stop));
+        return travel.between(x, y, stopX(stop), stopY(stop));
+    }
+
+    Request request(int index) const {
+        return {ids[index], {originX[index], originY[index]}, {destX[index], destY[index]},
+                releaseTime[index], deadline[index], payment[index]};
+    }
+
+    std::vector<int> allIndices() const {
+        std::vector<int> indices(size());
+        for (size_t i = 0; i < indices.size(); i++) indices[i] = static_cast<int>(i);
+        return indices;
+    }
+
+private:
+    // id -> índice. La tabla densa cubre ids desde idBase y crece hasta 2 posiciones por
+    // fila reservada (más 1024); los ids fuera de ese rango, de logs con ids dispersos,
+    // van al hash para no reservar memoria por cada id sin usar
+    std::vector<int> indexById;
+    std::unordered_map<int, int> sparseIndex;
+    int idBase = 0;
+
+    void indexId(int id, int index) {
+        const size_t slot = slotOf(id);
+        if (slot < 2 * ids.capacity() + 1024) {
+            if (slot >= indexById.size()) indexById.resize(slot + 1, -1);
+            indexById[slot] = index;
+        } else {
+            sparseIndex[id] = index;
+        }
+    }
+
+    // ids menores que idBase dan posiciones fuera de rango
+    size_t slotOf(int id) const { return static_cast<size_t>(static_cast<int64_t>(id) - idBase); }
+
+    void unindexId(int id) {
+        const size_t slot = slotOf(id);
+        if (slot < indexById.size()) indexById[slot] = -1;
+        sparseIndex.erase(id);
+    }
+
+    double stopX(int stop) const { return (stop & 1) ? destX[stop >> 1] : originX[stop >> 1]; }
+    double stopY(int stop) const { return (stop & 1) ? destY[stop >> 1] : originY[stop >> 1]; }
+    int stopNode(int stop) const { return (stop & 1) ? destNode[stop >> 1] : originNode[stop >> 1]; }
+};
+
+#endif
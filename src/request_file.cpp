@@ -0,0 +1,201 @@
+#include "request_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[8] = {'R', 'S', 'P', 'C', 'O', 'L', 'S', '\0'};
+constexpr size_t ALIGNMENT = 64;
+
+size_t alignUp(size_t n) {
+    return (n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+// Posición de cada columna dado el ancho de sus elementos
+std::vector<size_t> columnOffsets(const std::vector<size_t>& widths, size_t count, size_t& total) {
+    std::vector<size_t> offsets;
+    size_t offset = sizeof(ColumnFileHeader);
+    for (size_t width : widths) {
+        offsets.push_back(offset);
+        offset = alignUp(offset + width * count);
+    }
+    total = offset;
+    return offsets;
+}
+
+const std::vector<size_t> REQUEST_WIDTHS = {4, 8, 8, 8, 8, 4, 4, 8};
+const std::vector<size_t> VEHICLE_WIDTHS = {4, 8, 8, 4};
+
+// FNV-1a sobre palabras de 64 bits (el tamaño es múltiplo de 64 por el alineamiento)
+uint64_t checksum(const char* bytes, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t k = 0; k + 8 <= length; k += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + k, 8);
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Arma el archivo completo en memoria: columnas con relleno en cero y la cabecera al final
+class ColumnWriter {
+public:
+    ColumnWriter(ColumnFileKind kind, const std::vector<size_t>& widths, size_t count, uint32_t flags)
+        : offsets(columnOffsets(widths, count, total)), buffer(total, 0) {
+        ColumnFileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = COLUMN_FILE_VERSION;
+        header.kind = static_cast<uint32_t>(kind);
+        header.count = count;
+        header.flags = flags;
+        std::memcpy(buffer.data(), &header, sizeof(header));
+    }
+
+    template <typename T>
+    void put(int column, size_t row, T value) {
+        std::memcpy(&buffer[offsets[column] + row * sizeof(T)], &value, sizeof(T));
+    }
+
+    void write(const std::string& path) {
+        uint64_t sum = checksum(buffer.data() + sizeof(ColumnFileHeader), total - sizeof(ColumnFileHeader));
+        std::memcpy(buffer.data() + offsetof(ColumnFileHeader, checksum), &sum, sizeof(sum));
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out) throw std::runtime_error("writeColumnFile: cannot open " + path);
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!out) throw std::runtime_error("writeColumnFile: write failed for " + path);
+    }
+
+private:
+    size_t total = 0;
+    std::vector<size_t> offsets;
+    std::vector<char> buffer;
+};
+
+}
+
+void writeRequestFile(const std::string& path, const std::vector<Request>& requests) {
+    bool sorted = std::is_sorted(requests.begin(), requests.end(),
+                                 [](const Request& a, const Request& b) { return a.releaseTime < b.releaseTime; });
+    ColumnWriter writer(ColumnFileKind::Requests, REQUEST_WIDTHS, requests.size(), sorted ? SORTED_BY_RELEASE : 0);
+    for (size_t i = 0; i < requests.size(); i++) {
+        const Request& r = requests[i];
+        writer.put<int32_t>(0, i, r.id);
+        writer.put<double>(1, i, r.origin.first);
+        writer.put<double>(2, i, r.origin.second);
+        writer.put<double>(3, i, r.destination.first);
+        writer.put<double>(4, i, r.destination.second);
+        writer.put<int32_t>(5, i, r.releaseTime);
+        writer.put<int32_t>(6, i, r.deadline);
+        writer.put<double>(7, i, r.payment);
+    }
+    writer.write(path);
+}
+
+void writeVehicleFile(const std::string& path, const std::vector<Vehicle>& vehicles) {
+    ColumnWriter writer(ColumnFileKind::Vehicles, VEHICLE_WIDTHS, vehicles.size(), 0);
+    for (size_t i = 0; i < vehicles.size(); i++) {
+        const Vehicle& v = vehicles[i];
+        writer.put<int32_t>(0, i, v.id);
+        writer.put<double>(1, i, v.location.first);
+        writer.put<double>(2, i, v.location.second);
+        writer.put<int32_t>(3, i, v.capacity);
+    }
+    writer.write(path);
+}
+
+MappedColumns::MappedColumns(const std::string& path, ColumnFileKind kind, bool verifyChecksum) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("MappedColumns: cannot open " + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ColumnFileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("MappedColumns: " + path + " is too short");
+    }
+    length = static_cast<size_t>(info.st_size);
+    data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        data = nullptr;
+        throw std::runtime_error("MappedColumns: mmap failed for " + path);
+    }
+
+    auto fail = [&](const std::string& reason) {
+        ::munmap(data, length);
+        data = nullptr;
+        throw std::runtime_error("MappedColumns: " + path + ": " + reason);
+    };
+    const ColumnFileHeader* h = header();
+    if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0) fail("not a column file");
+    if (h->version != COLUMN_FILE_VERSION) fail("unsupported version");
+    if (h->kind != static_cast<uint32_t>(kind)) fail("wrong record kind");
+
+    count = h->count;
+    size_t total = 0;
+    offsets = columnOffsets(kind == ColumnFileKind::Requests ? REQUEST_WIDTHS : VEHICLE_WIDTHS, count, total);
+    if (total != length) fail("size does not match the header");
+    if (verifyChecksum) {
+        const char* bytes = static_cast<const char*>(data);
+        if (checksum(bytes + sizeof(ColumnFileHeader), length - sizeof(ColumnFileHeader)) != h->checksum) fail("checksum mismatch");
+    }
+}
+
+MappedColumns::~MappedColumns() {
+    if (data) ::munmap(data, length);
+}
+
+RequestFile::RequestFile(const std::string& path, bool verifyChecksum)
+    : MappedColumns(path, ColumnFileKind::Requests, verifyChecksum) {}
+
+std::vector<Request> RequestFile::requests() const {
+    std::vector<Request> result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); i++) result.push_back(request(i));
+    return result;
+}
+
+RequestCatalog RequestFile::catalog(TravelOracle travel) const {
+    RequestCatalog result({}, std::move(travel));
+    size_t n = size();
+    result.appendRows(n);  // columnas copiadas en bloque desde el mapeo
+    std::copy_n(ids(), n, result.ids.begin());
+    std::copy_n(originX(), n, result.originX.begin());
+    std::copy_n(originY(), n, result.originY.begin());
+    std::copy_n(destX(), n, result.destX.begin());
+    std::copy_n(destY(), n, result.destY.begin());
+    std::copy_n(releaseTime(), n, result.releaseTime.begin());
+    std::copy_n(deadline(), n, result.deadline.begin());
+    std::copy_n(payment(), n, result.payment.begin());
+    result.commitRows(0);
+    return result;
+}
+
+VehicleFile::VehicleFile(const std::string& path, bool verifyChecksum)
+    : MappedColumns(path, ColumnFileKind::Vehicles, verifyChecksum) {}
+
+std::vector<Vehicle> VehicleFile::vehicles() const {
+    std::vector<Vehicle> result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); i++) {
+        result.push_back({ids()[i], {x()[i], y()[i]}, capacity()[i], {}, {}});
+    }
+    validateVehicles(result, "VehicleFile");
+    return result;
+}
+
+RequestStream::RequestStream(const std::string& path, bool verifyChecksum) : file(path, verifyChecksum) {
+    if (!file.sortedByRelease()) throw std::runtime_error("RequestStream: " + path + " is not sorted by release time");
+}
+
+size_t RequestStream::readUntil(int time, std::vector<Request>& out) {
+    size_t begin = cursor;
+    const int32_t* release = file.releaseTime();
+    while (cursor < file.size() && release[cursor] <= time) out.push_back(file.request(cursor++));
+    return cursor - begin;
+}
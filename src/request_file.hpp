@@ -0,0 +1,123 @@
+#ifndef REQUEST_FILE_HPP
+#define REQUEST_FILE_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "request.hpp"
+#include "vehicle.hpp"
+#include "request_catalog.hpp"
+
+// Formato binario por columnas (.rspc) para reproducir días completos de requests.
+// Cabecera de 64 bytes y después cada columna contigua, alineada a 64 bytes, en el
+// orden de la máquina (little-endian):
+//   requests:  id i32, originX f64, originY f64, destX f64, destY f64,
+//              releaseTime i32, deadline i32, payment f64
+//   vehículos: id i32, x f64, y f64, capacity i32
+// El checksum es FNV-1a sobre palabras de 64 bits de todo lo que sigue a la cabecera.
+// Los archivos se abren con mmap: las columnas se leen directamente del archivo.
+
+enum class ColumnFileKind : uint32_t { Requests = 1, Vehicles = 2 };
+
+struct ColumnFileHeader {
+    char magic[8];          // "RSPCOLS\0"
+    uint32_t version;
+    uint32_t kind;          // ColumnFileKind
+    uint64_t count;         // filas
+    uint64_t checksum;
+    uint32_t flags;
+    uint8_t reserved[28];
+};
+static_assert(sizeof(ColumnFileHeader) == 64, "la cabecera ocupa 64 bytes");
+
+constexpr uint32_t COLUMN_FILE_VERSION = 1;
+constexpr uint32_t SORTED_BY_RELEASE = 1u;  // flags: filas en orden de releaseTime
+
+// Lanzan std::runtime_error si no pueden escribir
+void writeRequestFile(const std::string& path, const std::vector<Request>& requests);
+void writeVehicleFile(const std::string& path, const std::vector<Vehicle>& vehicles);
+
+// Archivo mapeado en memoria (sólo lectura); base de los lectores
+class MappedColumns {
+public:
+    MappedColumns(const std::string& path, ColumnFileKind kind, bool verifyChecksum);
+    ~MappedColumns();
+    MappedColumns(const MappedColumns&) = delete;
+    MappedColumns& operator=(const MappedColumns&) = delete;
+
+    size_t size() const { return count; }
+    uint32_t flags() const { return header()->flags; }
+
+protected:
+    template <typename T>
+    const T* column(int index) const;  // index-ésima columna, de tamaño sizeof(T) * size()
+
+    std::vector<size_t> offsets;
+
+private:
+    const ColumnFileHeader* header() const { return static_cast<const ColumnFileHeader*>(data); }
+
+    void* data = nullptr;
+    size_t length = 0;
+    size_t count = 0;
+};
+
+class RequestFile : public MappedColumns {
+public:
+    // Lanza std::runtime_error si el archivo no existe, no es de requests o está corrupto
+    explicit RequestFile(const std::string& path, bool verifyChecksum = true);
+
+    bool sortedByRelease() const { return flags() & SORTED_BY_RELEASE; }
+
+    const int32_t* ids() const { return column<int32_t>(0); }
+    const double* originX() const { return column<double>(1); }
+    const double* originY() const { return column<double>(2); }
+    const double* destX() const { return column<double>(3); }
+    const double* destY() const { return column<double>(4); }
+    const int32_t* releaseTime() const { return column<int32_t>(5); }
+    const int32_t* deadline() const { return column<int32_t>(6); }
+    const double* payment() const { return column<double>(7); }
+
+    Request request(size_t i) const {
+        return {ids()[i], {originX()[i], originY()[i]}, {destX()[i], destY()[i]},
+                releaseTime()[i], deadline()[i], payment()[i]};
+    }
+    std::vector<Request> requests() const;
+    RequestCatalog catalog(TravelOracle travel = {}) const;
+};
+
+class VehicleFile : public MappedColumns {
+public:
+    explicit VehicleFile(const std::string& path, bool verifyChecksum = true);
+
+    const int32_t* ids() const { return column<int32_t>(0); }
+    const double* x() const { return column<double>(1); }
+    const double* y() const { return column<double>(2); }
+    const int32_t* capacity() const { return column<int32_t>(3); }
+
+    std::vector<Vehicle> vehicles() const;  // std::invalid_argument si una capacidad excede MAX_VEHICLE_CAPACITY
+};
+
+// Lectura secuencial para el despacho en línea: entrega por tandas los requests de un
+// archivo ordenado por releaseTime sin materializar el resto (mmap lee bajo demanda).
+class RequestStream {
+public:
+    explicit RequestStream(const std::string& path, bool verifyChecksum = true);
+
+    bool done() const { return cursor >= file.size(); }
+    int nextRelease() const { return file.releaseTime()[cursor]; }  // requiere !done()
+    // Agrega a out los requests con releaseTime <= time; devuelve cuántos
+    size_t readUntil(int time, std::vector<Request>& out);
+
+private:
+    RequestFile file;
+    size_t cursor = 0;
+};
+
+template <typename T>
+const T* MappedColumns::column(int index) const {
+    return reinterpret_cast<const T*>(static_cast<const char*>(data) + offsets[index]);
+}
+
+#endif
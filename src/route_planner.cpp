@@ -0,0 +1,186 @@
+#include "route_planner.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr double UNREACHABLE = std::numeric_limits<double>::infinity();
+
+constexpr int power3(int k) {
+    return k == 0 ? 1 : 3 * power3(k - 1);
+}
+
+}
+
+RoutePlanner::RoutePlanner(const RequestCatalog& catalog, const Vehicle& v)
+    : catalog(catalog), startX(v.location.first), startY(v.location.second),
+      startNode(catalog.travel.snap(v.location.first, v.location.second)), capacity(v.capacity),
+      feasibleUpTo(MAX_REQUESTS + 1, 1) {}
+
+void RoutePlanner::truncate(int count) {
+    if (count < n) n = std::max(count, 0);
+}
+
+bool RoutePlanner::assign(const int* indices, int count) {
+    int common = 0;
+    while (common < n && common < count && requests[common] == indices[common]) common++;
+    truncate(common);
+    for (int k = common; k < count; k++) push(indices[k]);
+    return feasible();
+}
+
+bool RoutePlanner::feasible() const {
+    return feasibleUpTo[n] != 0;
+}
+
+bool RoutePlanner::probe(int r) {
+    if (n >= MAX_REQUESTS || !feasible()) return false;
+    if (catalog.deadline[r] - (catalog.releaseTime[r] + catalog.tripTime[r]) < 1.0) return false;
+
+    double best = UNREACHABLE;
+    if (n == 0) {
+        best = catalog.timeToStop(startX, startY, startNode, 2 * r);
+    } else {
+        const size_t done = static_cast<size_t>(power3(n) - 1) * STOPS;
+        for (unsigned mask = reachable[power3(n) - 1]; mask; mask &= mask - 1) {
+            int last = __builtin_ctz(mask);
+            int from = 2 * requests[last / 2] + 1;
+            best = std::min(best, arrival[done + last] + catalog.stopTime(from, 2 * r));
+        }
+    }
+    if (best < catalog.releaseTime[r]) best = catalog.releaseTime[r];
+    best += catalog.tripTime[r];
+    if (catalog.deadline[r] - best >= 1.0) return true;
+
+    bool ok = push(r);
+    truncate(n - 1);
+    return ok;
+}
+
+bool RoutePlanner::push(int r) {
+    const int k = n;
+    if (k >= MAX_REQUESTS) return false;
+    requests[k] = r;
+    n = k + 1;
+
+    const int pickup = 2 * k, dropoff = 2 * k + 1;
+    for (int stop = 0; stop < pickup; stop++) {
+        int from = 2 * requests[stop / 2] + (stop & 1);
+        travel[stop][pickup] = catalog.stopTime(from, 2 * r);
+        travel[stop][dropoff] = catalog.stopTime(from, 2 * r + 1);
+        travel[pickup][stop] = catalog.stopTime(2 * r, from);
+        travel[dropoff][stop] = catalog.stopTime(2 * r + 1, from);
+    }
+    travel[pickup][dropoff] = catalog.tripTime[r];
+    fromStart[pickup] = catalog.timeToStop(startX, startY, startNode, 2 * r);
+
+    // un superconjunto de un grupo infactible es infactible
+    if (!feasibleUpTo[k] || catalog.deadline[r] - (catalog.releaseTime[r] + catalog.tripTime[r]) < 1.0) {
+        feasibleUpTo[n] = 0;
+        return false;
+    }
+
+    const int low = power3(k), high = power3(n);
+    arrival.resize(static_cast<size_t>(high) * STOPS);
+    previous.resize(static_cast<size_t>(high) * STOPS);
+    reachable.resize(high);
+
+    // los estados nuevos son los que ya recogieron el slot k; cada paso sube un dígito
+    // (0 -> 1 al recoger, 1 -> 2 al dejar), así que los predecesores tienen índice menor
+    int digit[MAX_REQUESTS] = {};
+    digit[k] = 1;
+    for (int s = low; s < high; s++) {
+        if (s > low) {  // s en base 3, incrementado dígito a dígito
+            for (int i = 0; ++digit[i] == 3; i++) digit[i] = 0;
+        }
+        double* row = &arrival[static_cast<size_t>(s) * STOPS];
+        signed char* from = &previous[static_cast<size_t>(s) * STOPS];
+        reachable[s] = 0;
+
+        int onboard = 0;
+        for (int i = 0; i < n; i++) onboard += digit[i] == 1;
+        if (onboard > capacity) continue;
+
+        for (int i = 0; i < n; i++) {
+            if (digit[i] == 0) continue;
+            const int stop = 2 * i + (digit[i] == 2);
+            const int p = s - power3(i);
+
+            double best = UNREACHABLE;
+            int bestFrom = -1;
+            if (p == 0) {
+                best = fromStart[stop];
+            } else {
+                const double* before = &arrival[static_cast<size_t>(p) * STOPS];
+                for (unsigned mask = reachable[p]; mask; mask &= mask - 1) {
+                    int last = __builtin_ctz(mask);
+                    double t = before[last] + travel[last][stop];
+                    if (t < best) {
+                        best = t;
+                        bestFrom = last;
+                    }
+                }
+                if (bestFrom < 0) continue;
+            }
+
+            int request = requests[i];
+            if (digit[i] == 1) {
+                if (best < catalog.releaseTime[request]) best = catalog.releaseTime[request];
+            } else if (catalog.deadline[request] - best < 1.0) {
+                continue;  // slack mínimo requerido
+            }
+            row[stop] = best;
+            from[stop] = static_cast<signed char>(bestFrom);
+            reachable[s] |= 1u << stop;
+        }
+    }
+
+    bool ok = reachable[high - 1] != 0;
+    feasibleUpTo[n] = ok;
+    return ok;
+}
+
+std::vector<RouteStop> RoutePlanner::route() const {
+    std::vector<RouteStop> stops;
+    if (n == 0 || !feasible()) return stops;
+
+    int s = power3(n) - 1;
+    int stop = -1;
+    for (unsigned mask = reachable[s]; mask; mask &= mask - 1) {
+        int candidate = __builtin_ctz(mask);
+        if (stop < 0 || arrival[static_cast<size_t>(s) * STOPS + candidate] < arrival[static_cast<size_t>(s) * STOPS + stop]) {
+            stop = candidate;
+        }
+    }
+    while (stop >= 0) {
+        stops.push_back({catalog.ids[requests[stop / 2]], (stop & 1) == 0});
+        int before = previous[static_cast<size_t>(s) * STOPS + stop];
+        s -= power3(stop / 2);
+        stop = before;
+    }
+    std::reverse(stops.begin(), stops.end());
+    return stops;
+}
+
+std::vector<RouteStop> sequentialRoute(const RequestCatalog& catalog, const std::vector<int>& indices) {
+    std::vector<RouteStop> stops;
+    for (int r : indices) {
+        stops.push_back({catalog.ids[r], true});
+        stops.push_back({catalog.ids[r], false});
+    }
+    return stops;
+}
+
+double routeEndTime(const RequestCatalog& catalog, const Vehicle& v, const std::vector<RouteStop>& route) {
+    int node = catalog.travel.snap(v.location.first, v.location.second);
+    double time = 0;
+    int last = -1;
+    for (const RouteStop& stop : route) {
+        int r = catalog.indexOf(stop.requestId);
+        int s = stop.pickup ? 2 * r : 2 * r + 1;
+        time += last < 0 ? catalog.timeToStop(v.location.first, v.location.second, node, s) : catalog.stopTime(last, s);
+        if (stop.pickup && time < catalog.releaseTime[r]) time = catalog.releaseTime[r];
+        last = s;
+    }
+    return time;
+}
@@ -0,0 +1,66 @@
+#ifndef ROUTE_PLANNER_HPP
+#define ROUTE_PLANNER_HPP
+
+#include <vector>
+#include <cstdint>
+#include "vehicle.hpp"
+#include "request_catalog.hpp"
+
+// Mejor orden de recogidas y entregas para un grupo chico de requests de un vehículo.
+// Programación dinámica hacia adelante sobre estados (cada request: sin recoger, a
+// bordo o entregado) x última parada, guardando la llegada más temprana que respeta
+// capacidad, releaseTime y slack >= 1 en cada entrega; llegar antes nunca empeora el
+// resto de la ruta, así que el grupo es factible sii el estado final es alcanzable.
+//
+// Los requests se agregan y quitan como una pila: los estados que no tocan al último
+// request no cambian, de modo que grupos con el mismo prefijo reutilizan la tabla.
+// La ruta secuencial (recoger y dejar cada request en orden) es uno de los caminos y
+// se calcula con las mismas operaciones que calculateMinSlack, así que todo grupo
+// factible con esa ruta también lo es aquí.
+class RoutePlanner {
+public:
+    static constexpr int MAX_REQUESTS = 8;  // la tabla ocupa 3^n x 2n entradas
+
+    RoutePlanner(const RequestCatalog& catalog, const Vehicle& v);
+
+    // Agrega r (índice del catálogo) y devuelve si el grupo sigue siendo factible
+    bool push(int r);
+    void truncate(int count);  // conserva los primeros count requests
+    // Si el grupo actual más r es factible, sin conservar r. Primero prueba atender r
+    // al final de la mejor ruta actual y sólo si no alcanza resuelve la tabla completa.
+    bool probe(int r);
+    // Carga el grupo indices[0..count) reutilizando el prefijo común con el actual
+    bool assign(const int* indices, int count);
+
+    int size() const { return n; }
+    bool feasible() const;
+
+    // Ruta con la entrega final más temprana (vacía si el grupo no es factible)
+    std::vector<RouteStop> route() const;
+
+private:
+    static constexpr int STOPS = 2 * MAX_REQUESTS;  // parada 2i recoge el slot i, 2i+1 lo deja
+
+    const RequestCatalog& catalog;
+    double startX, startY;
+    int startNode;  // punto de la tabla de la posición del vehículo
+    int capacity;
+
+    int n = 0;
+    int requests[MAX_REQUESTS];
+    double travel[STOPS][STOPS];  // tiempos entre las paradas del grupo
+    double fromStart[STOPS];      // del vehículo a cada recogida
+    std::vector<double> arrival;  // arrival[s * STOPS + parada], válido si la parada está en reachable[s]
+    std::vector<signed char> previous;
+    std::vector<uint16_t> reachable;  // máscara de paradas alcanzables de cada estado
+    std::vector<int> feasibleUpTo;  // feasibleUpTo[k]: el prefijo de k requests es factible
+};
+
+// Ruta sin optimizar: recoger y dejar cada request en el orden dado
+std::vector<RouteStop> sequentialRoute(const RequestCatalog& catalog, const std::vector<int>& indices);
+
+// Instante de la última parada al recorrer route desde la posición de v (tiempo 0),
+// esperando el releaseTime en cada recogida como lo hacen los planners
+double routeEndTime(const RequestCatalog& catalog, const Vehicle& v, const std::vector<RouteStop>& route);
+
+#endif
@@ -0,0 +1,88 @@
+#include "shareability_graph.hpp"
+#include "spatial_grid.hpp"
+#include "time_window_index.hpp"
+#include "parallel.hpp"
+#include "utils.hpp"
+#include "trace.hpp"
+#include <stdexcept>
+
+ShareabilityGraph::ShareabilityGraph(const RequestCatalog& catalog, int numThreads, PlannerStats* stats, bool anyOrder)
+    : n(catalog.size()), wordsPerRow((catalog.size() + 63) / 64), stats(stats) {
+    if (n > MAX_REQUESTS) throw std::length_error("ShareabilityGraph: too many requests for a dense bit matrix");
+    bits.assign(n * wordsPerRow, 0);
+    solo.assign(n, 0);
+
+    double latestArrival = -1e18;  // max(deadline - 1 - viaje) de los posibles sucesores
+    double earliestRelease = 1e18;
+    std::vector<int> servable;
+    for (size_t r = 0; r < n; r++) {
+        int i = static_cast<int>(r);
+        solo[r] = catalog.deadline[i] - (catalog.releaseTime[i] + tripLength(catalog, i)) >= 1.0;
+        latestArrival = std::max(latestArrival, catalog.deadline[i] - 1.0 - tripLength(catalog, i));
+        earliestRelease = std::min<double>(earliestRelease, catalog.releaseTime[i]);
+        if (solo[r]) servable.push_back(i);
+    }
+
+    // En orden fijo los sucesores de a salen del índice temporal (con cualquier métrica);
+    // en cualquier orden la cota es simétrica y se usa la grilla con el radio más holgado.
+    // Con una tabla de tiempos el radio euclídeo no acota nada y sin índice se prueban
+    // todos los pares.
+    std::unique_ptr<TimeWindowIndex> windows;
+    std::unique_ptr<SpatialGrid> grid;
+    if (!anyOrder) windows = std::make_unique<TimeWindowIndex>(catalog, servable);
+    else if (catalog.travel.boundedByEuclidean()) grid = std::make_unique<SpatialGrid>(catalog, catalog.allIndices());
+    parallelFor(n, resolveThreadCount(numThreads), [&](size_t r) {
+        int a = static_cast<int>(r);
+        if (!solo[a]) return;
+        uint64_t* row = &bits[r * wordsPerRow];
+        auto link = [&](int b) {
+            if (b != a && solo[b] && (anyOrder ? pairBoundHoldsAnyOrder(catalog, a, b) : pairBoundHolds(catalog, a, b))) {
+                row[b >> 6] |= uint64_t(1) << (b & 63);
+            }
+        };
+        if (windows) {
+            windows->forEachReachableAfter(catalog.releaseTime[a] + tripLength(catalog, a),
+                                           catalog.destX[a], catalog.destY[a], link);
+            return;
+        }
+        if (!grid) {
+            for (size_t b = 0; b < n; b++) link(static_cast<int>(b));
+            return;
+        }
+        // b se recoge antes o después de a, pero siempre se viaja entre ambos orígenes
+        double radius = std::max(latestArrival - catalog.releaseTime[a],
+                                 catalog.deadline[a] - 1.0 - tripLength(catalog, a) - earliestRelease);
+        grid->forEachWithin(catalog.originX[a], catalog.originY[a], radius + 1e-6 * (1.0 + std::abs(radius)),
+                            [&](int b, double) { link(b); });
+    });
+}
+
+bool ShareabilityGraph::compatible(const int* order, int count) const {
+    if (stats) stats->pairChecks.fetch_add(1, std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        bool ok = canServe(order[i]);
+        for (int j = i + 1; ok && j < count; j++) ok = canFollow(order[i], order[j]);
+        if (!ok) {
+            if (stats) stats->pairRejects.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ShareabilityGraph::canAppend(const int* order, int count, int next) const {
+    if (stats) stats->pairChecks.fetch_add(1, std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (!canFollow(order[i], next)) {
+            if (stats) stats->pairRejects.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<ShareabilityGraph> makeShareabilityGraph(const RequestCatalog& catalog, const PlannerOptions& options) {
+    if (!options.pairGraph || catalog.size() > ShareabilityGraph::MAX_REQUESTS) return nullptr;
+    TRACE_SCOPE("pair_graph.build");
+    return std::make_unique<ShareabilityGraph>(catalog, options.numThreads, options.stats, options.optimizeRouteOrder);
+}
@@ -0,0 +1,66 @@
+#ifndef SHAREABILITY_GRAPH_HPP
+#define SHAREABILITY_GRAPH_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "request_catalog.hpp"
+#include "planner_options.hpp"
+
+// Matriz de bits dirigida, independiente del vehículo: canFollow(a, b) indica si b
+// puede atenderse después de a (índices del catálogo) sin violar su deadline, usando
+// la cota release_a + viaje_a + dist(destino_a, origen_b) + viaje_b <= deadline_b - 1.
+// Un grupo sólo es factible si todos sus pares en el orden de visita lo son, así que
+// la matriz descarta grupos con operaciones de bits antes de simular la ruta.
+// Con anyOrder la relación es simétrica (pairBoundHoldsAnyOrder) y vale para rutas
+// con las paradas intercaladas.
+class ShareabilityGraph {
+public:
+    static constexpr size_t MAX_REQUESTS = 20000;  // la matriz ocupa n^2 / 8 bytes
+
+    ShareabilityGraph(const RequestCatalog& catalog, int numThreads = 1, PlannerStats* stats = nullptr,
+                      bool anyOrder = false);
+
+    bool canServe(int r) const { return solo[r] != 0; }
+    bool canFollow(int a, int b) const {
+        return (bits[static_cast<size_t>(a) * wordsPerRow + (b >> 6)] >> (b & 63)) & 1u;
+    }
+
+    // order: índices del catálogo en el orden de visita
+    bool compatible(const int* order, int count) const;
+
+    // Extender un grupo ya compatible con next al final del recorrido
+    bool canAppend(const int* order, int count, int next) const;
+
+    // fn(b) para cada b que puede seguir a a, en orden creciente de índice
+    template <typename Fn>
+    void forEachFollower(int a, Fn&& fn) const;
+
+    size_t size() const { return n; }
+
+private:
+    size_t n = 0;
+    size_t wordsPerRow = 0;
+    std::vector<uint64_t> bits;
+    std::vector<uint8_t> solo;  // el request es factible por sí solo
+    PlannerStats* stats;
+};
+
+// La matriz de la ronda según options (nullptr si está desactivada o es demasiado grande)
+std::unique_ptr<ShareabilityGraph> makeShareabilityGraph(const RequestCatalog& catalog, const PlannerOptions& options);
+
+template <typename Fn>
+void ShareabilityGraph::forEachFollower(int a, Fn&& fn) const {
+    const uint64_t* row = &bits[static_cast<size_t>(a) * wordsPerRow];
+    for (size_t w = 0; w < wordsPerRow; w++) {
+        uint64_t word = row[w];
+        while (word) {
+            int bit = __builtin_ctzll(word);
+            fn(static_cast<int>(w * 64 + bit));
+            word &= word - 1;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include "slack_kernel.hpp"
+#include "utils.hpp"
+#include <atomic>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define SLACK_KERNEL_X86 1
+#endif
+
+namespace {
+
+void slackScalar(const RouteState& start, const RequestCatalog& catalog, int k,
+                 const int* groups, size_t begin, size_t count, double* slack, double* endTime) {
+    for (size_t g = begin; g < count; g++) {
+        RouteState route = start;
+        double minSlack = 1e9;
+        for (int j = 0; j < k; j++) {
+            double s = appendToRoute(route, catalog, groups[g * k + j]);
+            if (s < 0) {  //violación de tiempo
+                minSlack = -1;
+                break;
+            }
+            minSlack = std::min(minSlack, s);
+        }
+        slack[g] = minSlack;
+        if (endTime) endTime[g] = route.time;
+    }
+}
+
+#ifdef SLACK_KERNEL_X86
+
+// Las variantes con máscara evitan leer un registro destino sin inicializar
+__attribute__((target("avx2")))
+inline __m256d gather4(const double* base, __m128i idx) {
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, idx, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+}
+
+__attribute__((target("avx2")))
+inline __m256d gather4(const int* base, __m128i idx) {
+    return _mm256_cvtepi32_pd(_mm_mask_i32gather_epi32(_mm_setzero_si128(), base, idx, _mm_set1_epi32(-1), 4));
+}
+
+// GCC 12 avisa por _mm512_undefined_pd dentro de sus propios intrínsecos
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f")))
+inline __m512d gather8(const double* base, __m256i idx) {
+    return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, idx, base, 8);
+}
+
+__attribute__((target("avx512f")))
+inline __m512d gather8(const int* base, __m256i idx) {
+    return _mm512_cvtepi32_pd(_mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base, idx, _mm256_set1_epi32(-1), 4));
+}
+
+// Mismas operaciones y en el mismo orden que appendToRoute con métrica euclídea; sin
+// FMA (el archivo se compila con -ffp-contract=off) para no cambiar el redondeo.
+__attribute__((target("avx2")))
+void slackAVX2(const RouteState& start, const RequestCatalog& catalog, int k,
+               const int* groups, size_t count, double* slack, double* endTime) {
+    const __m256d zero = _mm256_setzero_pd();
+    const double startX = start.last < 0 ? start.x : catalog.destX[start.last];
+    const double startY = start.last < 0 ? start.y : catalog.destY[start.last];
+    size_t g = 0;
+    for (; g + 4 <= count; g += 4) {
+        __m256d time = _mm256_set1_pd(start.time);
+        __m256d lastX = _mm256_set1_pd(startX);
+        __m256d lastY = _mm256_set1_pd(startY);
+        __m256d minSlack = _mm256_set1_pd(1e9);
+        __m256d failed = zero;
+
+        for (int j = 0; j < k; j++) {
+            const int* base = groups + g * k + j;
+            __m128i idx = _mm_set_epi32(base[3 * k], base[2 * k], base[k], base[0]);
+            __m256d ox = gather4(catalog.originX.data(), idx);
+            __m256d oy = gather4(catalog.originY.data(), idx);
+            __m256d dx = gather4(catalog.destX.data(), idx);
+            __m256d dy = gather4(catalog.destY.data(), idx);
+            __m256d release = gather4(catalog.releaseTime.data(), idx);
+            __m256d deadline = gather4(catalog.deadline.data(), idx);
+
+            __m256d ax = _mm256_sub_pd(lastX, ox), ay = _mm256_sub_pd(lastY, oy);
+            time = _mm256_add_pd(time, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(ax, ax), _mm256_mul_pd(ay, ay))));
+            time = _mm256_max_pd(time, release);
+            time = _mm256_add_pd(time, gather4(catalog.tripTime.data(), idx));
+
+            __m256d s = _mm256_sub_pd(deadline, time);
+            failed = _mm256_or_pd(failed, _mm256_cmp_pd(s, zero, _CMP_LT_OQ));
+            minSlack = _mm256_min_pd(s, minSlack);
+            lastX = dx;
+            lastY = dy;
+
+            if (_mm256_movemask_pd(failed) == 0xF) break;  // todas las rutas del bloque ya fallaron
+        }
+        _mm256_storeu_pd(slack + g, _mm256_blendv_pd(minSlack, _mm256_set1_pd(-1.0), failed));
+        if (endTime) _mm256_storeu_pd(endTime + g, time);
+    }
+    slackScalar(start, catalog, k, groups, g, count, slack, endTime);
+}
+
+__attribute__((target("avx512f")))
+void slackAVX512(const RouteState& start, const RequestCatalog& catalog, int k,
+                 const int* groups, size_t count, double* slack, double* endTime) {
+    const __m512d zero = _mm512_setzero_pd();
+    const double startX = start.last < 0 ? start.x : catalog.destX[start.last];
+    const double startY = start.last < 0 ? start.y : catalog.destY[start.last];
+    size_t g = 0;
+    for (; g + 8 <= count; g += 8) {
+        __m512d time = _mm512_set1_pd(start.time);
+        __m512d lastX = _mm512_set1_pd(startX);
+        __m512d lastY = _mm512_set1_pd(startY);
+        __m512d minSlack = _mm512_set1_pd(1e9);
+        __mmask8 failed = 0;
+
+        for (int j = 0; j < k; j++) {
+            const int* base = groups + g * k + j;
+            __m256i idx = _mm256_set_epi32(base[7 * k], base[6 * k], base[5 * k], base[4 * k],
+                                           base[3 * k], base[2 * k], base[k], base[0]);
+            __m512d ox = gather8(catalog.originX.data(), idx);
+            __m512d oy = gather8(catalog.originY.data(), idx);
+            __m512d dx = gather8(catalog.destX.data(), idx);
+            __m512d dy = gather8(catalog.destY.data(), idx);
+            __m512d release = gather8(catalog.releaseTime.data(), idx);
+            __m512d deadline = gather8(catalog.deadline.data(), idx);
+
+            __m512d ax = _mm512_sub_pd(lastX, ox), ay = _mm512_sub_pd(lastY, oy);
+            time = _mm512_add_pd(time, _mm512_sqrt_pd(_mm512_add_pd(_mm512_mul_pd(ax, ax), _mm512_mul_pd(ay, ay))));
+            time = _mm512_max_pd(time, release);
+            time = _mm512_add_pd(time, gather8(catalog.tripTime.data(), idx));
+
+            __m512d s = _mm512_sub_pd(deadline, time);
+            failed |= _mm512_cmp_pd_mask(s, zero, _CMP_LT_OQ);
+            minSlack = _mm512_min_pd(s, minSlack);
+            lastX = dx;
+            lastY = dy;
+
+            if (failed == 0xFF) break;  // todas las rutas del bloque ya fallaron
+        }
+        _mm512_storeu_pd(slack + g, _mm512_mask_blend_pd(failed, minSlack, _mm512_set1_pd(-1.0)));
+        if (endTime) _mm512_storeu_pd(endTime + g, time);
+    }
+    slackScalar(start, catalog, k, groups, g, count, slack, endTime);
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+bool supported(SlackKernel kernel) {
+#ifdef SLACK_KERNEL_X86
+    if (kernel == SlackKernel::AVX2) return __builtin_cpu_supports("avx2");
+    if (kernel == SlackKernel::AVX512) return __builtin_cpu_supports("avx512f");
+#endif
+    return kernel == SlackKernel::Scalar;
+}
+
+SlackKernel resolve(SlackKernel kernel) {
+    if (kernel == SlackKernel::Auto) {
+        if (supported(SlackKernel::AVX512)) return SlackKernel::AVX512;
+        if (supported(SlackKernel::AVX2)) return SlackKernel::AVX2;
+        return SlackKernel::Scalar;
+    }
+    return supported(kernel) ? kernel : SlackKernel::Scalar;
+}
+
+std::atomic<SlackKernel> selected{resolve(SlackKernel::Auto)};
+
+}
+
+void calculateMinSlackBatch(const RouteState& start, const RequestCatalog& catalog, int k,
+                            const int* groups, size_t count, double* slack, double* endTime) {
+    if (k <= 0) {  // grupo vacío: mismo valor que calculateMinSlack
+        for (size_t g = 0; g < count; g++) {
+            slack[g] = 1e9;
+            if (endTime) endTime[g] = start.time;
+        }
+        return;
+    }
+    if (catalog.travel.metric() != TravelMetric::Euclidean) {  // los kernels vectoriales calculan distancias euclídeas
+        slackScalar(start, catalog, k, groups, 0, count, slack, endTime);
+        return;
+    }
+    switch (selected.load(std::memory_order_relaxed)) {
+#ifdef SLACK_KERNEL_X86
+        case SlackKernel::AVX512: slackAVX512(start, catalog, k, groups, count, slack, endTime); return;
+        case SlackKernel::AVX2:   slackAVX2(start, catalog, k, groups, count, slack, endTime); return;
+#endif
+        default: slackScalar(start, catalog, k, groups, 0, count, slack, endTime); return;
+    }
+}
+
+void setSlackKernel(SlackKernel kernel) {
+    selected = resolve(kernel);
+}
+
+SlackKernel activeSlackKernel() {
+    return selected;
+}
+
+const char* slackKernelName(SlackKernel kernel) {
+    switch (kernel) {
+        case SlackKernel::Auto:   return "auto";
+        case SlackKernel::Scalar: return "scalar";
+        case SlackKernel::AVX2:   return "avx2";
+        case SlackKernel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
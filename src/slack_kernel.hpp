@@ -0,0 +1,24 @@
+#ifndef SLACK_KERNEL_HPP
+#define SLACK_KERNEL_HPP
+
+#include <cstddef>
+#include "request_catalog.hpp"
+#include "utils.hpp"
+
+enum class SlackKernel { Auto, Scalar, AVX2, AVX512 };
+
+// Extiende la ruta start con cada uno de count grupos del mismo tamaño k, a la vez.
+// groups[g * k + j] es el j-ésimo request (índice del catálogo, en orden de visita)
+// del grupo g. slack[g] es el slack mínimo de los requests agregados (-1 si alguno
+// queda negativo), idéntico bit a bit a appendToRoute; endTime[g] (opcional) es el
+// tiempo final de la ruta, válido sólo si slack[g] >= 0. Desde startRoute equivale a
+// calculateMinSlack. Con métricas distintas de la euclídea se usa el camino escalar.
+void calculateMinSlackBatch(const RouteState& start, const RequestCatalog& catalog, int k,
+                            const int* groups, size_t count, double* slack, double* endTime = nullptr);
+
+// Auto elige el mejor kernel soportado por la CPU; pedir uno no soportado cae al escalar
+void setSlackKernel(SlackKernel kernel);
+SlackKernel activeSlackKernel();
+const char* slackKernelName(SlackKernel kernel);
+
+#endif
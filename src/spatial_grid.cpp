@@ -0,0 +1,85 @@
+#include "spatial_grid.hpp"
+
+SpatialGrid::SpatialGrid(const RequestCatalog& catalog, const std::vector<int>& indices)
+    : catalog(catalog), slot(catalog.size(), -1) {
+    if (indices.empty()) return;
+
+    double maxX = catalog.originX[indices[0]], maxY = catalog.originY[indices[0]];
+    minX = maxX;
+    minY = maxY;
+    for (int r : indices) {
+        minX = std::min(minX, catalog.originX[r]);
+        maxX = std::max(maxX, catalog.originX[r]);
+        minY = std::min(minY, catalog.originY[r]);
+        maxY = std::max(maxY, catalog.originY[r]);
+    }
+
+    // ~1 request por celda en promedio
+    double extent = std::max(maxX - minX, maxY - minY);
+    int side = std::clamp(static_cast<int>(std::ceil(std::sqrt(static_cast<double>(indices.size())))), 1, 1024);
+    cellSize = extent > 0 ? extent / side : 1.0;
+    cols = std::clamp(static_cast<int>((maxX - minX) / cellSize) + 1, 1, 1025);
+    rows = std::clamp(static_cast<int>((maxY - minY) / cellSize) + 1, 1, 1025);
+    cells.resize(static_cast<size_t>(cols) * rows);
+
+    for (int r : indices) {
+        Cell& cell = cells[cellY(catalog.originY[r]) * cols + cellX(catalog.originX[r])];
+        slot[r] = static_cast<int>(cell.members.size());
+        cell.members.push_back(r);
+        cell.maxWindow = std::max(cell.maxWindow, window(r));
+        count++;
+    }
+    for (const auto& cell : cells) maxWindow = std::max(maxWindow, cell.maxWindow);
+}
+
+double SpatialGrid::distanceToCell(double x, double y, int cx, int cy) const {
+    double left = minX + cx * cellSize, bottom = minY + cy * cellSize;
+    double dx = std::max({0.0, left - x, x - (left + cellSize)});
+    double dy = std::max({0.0, bottom - y, y - (bottom + cellSize)});
+    return std::max(0.0, planarDistance(dx, dy) - 1e-6 * (1.0 + cellSize));  // margen por redondeo
+}
+
+std::vector<int> SpatialGrid::reachableFrom(double x, double y) const {
+    std::vector<int> result;
+    if (maxWindow < 0) return result;
+
+    int node = catalog.travel.snap(x, y);
+    int x0 = cellX(x - maxWindow), x1 = cellX(x + maxWindow);
+    int y0 = cellY(y - maxWindow), y1 = cellY(y + maxWindow);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            const Cell& cell = cells[cy * cols + cx];
+            if (cell.members.empty() || distanceToCell(x, y, cx, cy) > cell.maxWindow) continue;
+            for (int r : cell.members) {
+                double distance = catalog.timeFrom(x, y, node, r);
+                if (distance <= (catalog.deadline[r] - catalog.releaseTime[r])) {
+                    result.push_back(r);
+                }
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void SpatialGrid::remove(int index) {
+    if (index < 0 || index >= static_cast<int>(slot.size()) || slot[index] < 0) return;
+    Cell& cell = cells[cellY(catalog.originY[index]) * cols + cellX(catalog.originX[index])];
+    int pos = slot[index];
+    int moved = cell.members.back();
+    cell.members[pos] = moved;
+    slot[moved] = pos;
+    cell.members.pop_back();
+    slot[index] = -1;
+    count--;
+
+    // las cotas se recalculan sólo si se fue el request que las fijaba
+    if (window(index) < cell.maxWindow) return;
+    double previous = cell.maxWindow;
+    cell.maxWindow = -1.0;
+    for (int r : cell.members) cell.maxWindow = std::max(cell.maxWindow, window(r));
+    if (cell.maxWindow < previous && previous >= maxWindow) {
+        maxWindow = -1.0;
+        for (const auto& other : cells) maxWindow = std::max(maxWindow, other.maxWindow);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef SPATIAL_GRID_HPP
+#define SPATIAL_GRID_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "request_catalog.hpp"
+#include "geometry.hpp"
+
+// Grilla uniforme sobre los orígenes de un conjunto de requests (índices del
+// catálogo). Responde consultas por radio y permite quitar requests a medida que se
+// asignan, en O(1) salvo cuando sale el de mayor ventana de su celda (se recalcula la
+// cota de la celda y, si era la global, la de la grilla). Las podas por radio sólo
+// son exactas si la métrica del catálogo nunca es menor que la distancia euclídea
+// (boundedByEuclidean).
+class SpatialGrid {
+public:
+    SpatialGrid(const RequestCatalog& catalog, const std::vector<int>& indices);
+
+    // Requests cuyo origen está a distancia <= deadline - releaseTime de (x, y),
+    // el mismo criterio que filterFeasibleRequests. Devuelve índices ordenados.
+    std::vector<int> reachableFrom(double x, double y) const;
+
+    // fn(index, distance) para cada origen a distancia <= radius de (x, y)
+    template <typename Fn>
+    void forEachWithin(double x, double y, double radius, Fn&& fn) const;
+
+    void remove(int index);
+    size_t size() const { return count; }
+
+private:
+    struct Cell {
+        std::vector<int> members;
+        double maxWindow = -1.0;  // mayor deadline - releaseTime en la celda (-1 = vacía)
+    };
+
+    const RequestCatalog& catalog;
+    double minX = 0, minY = 0;
+    double cellSize = 1.0;
+    int cols = 1, rows = 1;
+    size_t count = 0;
+    double maxWindow = -1.0;  // mayor maxWindow de las celdas: radio de reachableFrom
+    std::vector<Cell> cells;
+    std::vector<int> slot;  // posición de cada índice dentro de su celda (-1 = ausente)
+
+    int cellX(double x) const {
+        return static_cast<int>(std::clamp(std::floor((x - minX) / cellSize), 0.0, cols - 1.0));
+    }
+    int cellY(double y) const {
+        return static_cast<int>(std::clamp(std::floor((y - minY) / cellSize), 0.0, rows - 1.0));
+    }
+    double distanceToCell(double x, double y, int cx, int cy) const;
+    double window(int r) const { return static_cast<double>(catalog.deadline[r] - catalog.releaseTime[r]); }
+};
+
+template <typename Fn>
+void SpatialGrid::forEachWithin(double x, double y, double radius, Fn&& fn) const {
+    if (radius < 0 || count == 0) return;
+    int x0 = cellX(x - radius), x1 = cellX(x + radius);
+    int y0 = cellY(y - radius), y1 = cellY(y + radius);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            if (distanceToCell(x, y, cx, cy) > radius) continue;
+            for (int r : cells[cy * cols + cx].members) {
+                double d = planarDistance(x - catalog.originX[r], y - catalog.originY[r]);
+                if (d <= radius) fn(r, d);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,25 @@
+#include "time_window_index.hpp"
+
+TimeWindowIndex::TimeWindowIndex(const RequestCatalog& catalog, const std::vector<int>& indices, bool spatial)
+    : catalog(catalog), order(indices) {
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return latestArrival(a) < latestArrival(b); });
+    latest.reserve(order.size());
+    for (int r : order) latest.push_back(latestArrival(r));
+
+    // bloques de al menos 256 requests y a lo sumo 32 bloques: cada grilla guarda una
+    // posición por request del catálogo
+    bucketSize = std::max<size_t>(256, (order.size() + 31) / 32);
+    spatial = spatial && catalog.travel.boundedByEuclidean();
+    for (size_t begin = 0; begin < order.size(); begin += bucketSize) {
+        Bucket bucket;
+        bucket.begin = begin;
+        bucket.end = std::min(order.size(), begin + bucketSize);
+        bucket.maxLatest = latest[bucket.end - 1];
+        if (spatial) {
+            std::vector<int> members(order.begin() + bucket.begin, order.begin() + bucket.end);
+            bucket.grid = std::make_unique<SpatialGrid>(catalog, members);
+        }
+        buckets.push_back(std::move(bucket));
+    }
+}
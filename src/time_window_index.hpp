@@ -0,0 +1,65 @@
+#ifndef TIME_WINDOW_INDEX_HPP
+#define TIME_WINDOW_INDEX_HPP
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include "request_catalog.hpp"
+#include "spatial_grid.hpp"
+
+// Índice temporal de un conjunto de requests (índices del catálogo). Cada request b
+// tiene un límite de llegada: deadline - 1 - viaje, el último instante en que se puede
+// estar en su origen y todavía dejarlo con slack >= 1. Si el recorrido termina otro
+// request en el instante t, b sólo es alcanzable a continuación cuando su límite es
+// >= t. Los requests se ordenan por límite y se agrupan en bloques consecutivos; una
+// consulta recorre el sufijo de bloques que puede cumplirlo y, con métricas acotadas
+// por la distancia euclídea, la grilla de orígenes de cada bloque en el radio que deja
+// su límite más holgado. Devuelve candidatos: la cota exacta la aplica quien consulta.
+class TimeWindowIndex {
+public:
+    // spatial: usar grillas por bloque (sólo si la métrica es boundedByEuclidean)
+    TimeWindowIndex(const RequestCatalog& catalog, const std::vector<int>& indices, bool spatial = true);
+
+    // fn(b) para cada b cuyo límite de llegada es >= finish y, con grillas, cuyo origen
+    // está a distancia euclídea <= límite - finish de (x, y)
+    template <typename Fn>
+    void forEachReachableAfter(double finish, double x, double y, Fn&& fn) const;
+
+    size_t size() const { return order.size(); }
+
+private:
+    struct Bucket {
+        size_t begin = 0, end = 0;          // rango en order
+        double maxLatest = 0.0;
+        std::unique_ptr<SpatialGrid> grid;  // orígenes del bloque
+    };
+
+    static double margin(double t) { return 1e-6 * (1.0 + std::abs(t)); }  // por redondeo
+    double latestArrival(int r) const { return catalog.deadline[r] - 1.0 - catalog.tripTime[r]; }
+
+    const RequestCatalog& catalog;
+    std::vector<int> order;       // por límite de llegada creciente
+    std::vector<double> latest;   // límite de order[k]
+    std::vector<Bucket> buckets;
+    size_t bucketSize = 1;
+};
+
+template <typename Fn>
+void TimeWindowIndex::forEachReachableAfter(double finish, double x, double y, Fn&& fn) const {
+    const double earliest = finish - margin(finish);
+    const size_t first = std::lower_bound(latest.begin(), latest.end(), earliest) - latest.begin();
+    for (size_t k = first / bucketSize; k < buckets.size(); k++) {
+        const Bucket& bucket = buckets[k];
+        if (!bucket.grid) {
+            for (size_t p = std::max(bucket.begin, first); p < bucket.end; p++) fn(order[p]);
+            continue;
+        }
+        double radius = bucket.maxLatest - finish;
+        bucket.grid->forEachWithin(x, y, radius + margin(radius), [&](int b, double) {
+            if (latestArrival(b) >= earliest) fn(b);
+        });
+    }
+}
+
+#endif
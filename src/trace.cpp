@@ -0,0 +1,179 @@
+#include "trace.hpp"
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <atomic>
+#include <algorithm>
+
+namespace trace {
+
+namespace {
+
+struct Event {
+    int slot;
+    int64_t startNs;  // desde el inicio del proceso
+    int64_t durationNs;
+};
+
+// Buffer de un hilo; su dueño lo escribe sin lock y los demás sólo lo tocan con el
+// registro bloqueado mientras nadie mide (ver trace.hpp). Queda en el registro al
+// terminar el hilo y resetTotals lo libera.
+struct ThreadBuffer {
+    int tid = 0;
+    bool retired = false;
+    std::vector<uint64_t> calls, nanos, counts;
+    std::vector<Event> events;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> phaseNames, counterNames;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    int nextTid = 1;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+std::atomic<bool> recording{false};
+
+struct ThreadHandle {
+    ThreadBuffer* buffer = nullptr;
+    ~ThreadHandle() {
+        if (!buffer) return;
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        buffer->retired = true;
+    }
+};
+
+ThreadBuffer& localBuffer() {
+    thread_local ThreadHandle handle;
+    if (!handle.buffer) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.buffers.push_back(std::make_unique<ThreadBuffer>());
+        handle.buffer = r.buffers.back().get();
+        handle.buffer->tid = r.nextTid++;
+    }
+    return *handle.buffer;
+}
+
+int slotFor(std::vector<std::string>& names, const char* name) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end()) return static_cast<int>(it - names.begin());
+    names.emplace_back(name);
+    return static_cast<int>(names.size() - 1);
+}
+
+void bump(std::vector<uint64_t>& values, int slot, uint64_t n) {
+    if (static_cast<size_t>(slot) >= values.size()) values.resize(slot + 1, 0);
+    values[slot] += n;
+}
+
+void writeEscaped(std::ofstream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+}
+
+void initialize() { registry(); }
+
+int phaseSlot(const char* name) { return slotFor(registry().phaseNames, name); }
+int counterSlot(const char* name) { return slotFor(registry().counterNames, name); }
+
+void addCount(int slot, uint64_t n) { bump(localBuffer().counts, slot, n); }
+
+Scope::~Scope() {
+    auto end = std::chrono::steady_clock::now();
+    int64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    ThreadBuffer& buffer = localBuffer();
+    bump(buffer.calls, slot, 1);
+    bump(buffer.nanos, slot, static_cast<uint64_t>(duration));
+    if (recording.load(std::memory_order_relaxed)) {
+        int64_t offset = std::chrono::duration_cast<std::chrono::nanoseconds>(start - registry().origin).count();
+        buffer.events.push_back({slot, offset, duration});
+    }
+}
+
+void setRecording(bool on) { recording = on; }
+
+void resetTotals() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (auto& buffer : r.buffers) {
+        buffer->calls.clear();
+        buffer->nanos.clear();
+        buffer->counts.clear();
+    }
+    // los hilos terminados sin eventos pendientes ya no aportan nada
+    r.buffers.erase(std::remove_if(r.buffers.begin(), r.buffers.end(),
+                                   [](const auto& b) { return b->retired && b->events.empty(); }),
+                    r.buffers.end());
+}
+
+std::vector<PhaseTotal> phases() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<PhaseTotal> totals(r.phaseNames.size());
+    for (size_t s = 0; s < totals.size(); s++) totals[s].name = r.phaseNames[s];
+    for (const auto& buffer : r.buffers) {
+        for (size_t s = 0; s < buffer->calls.size(); s++) {
+            totals[s].calls += buffer->calls[s];
+            totals[s].totalMs += buffer->nanos[s] / 1e6;
+        }
+    }
+    totals.erase(std::remove_if(totals.begin(), totals.end(), [](const PhaseTotal& p) { return p.calls == 0; }),
+                 totals.end());
+    return totals;
+}
+
+std::vector<CounterTotal> counters() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<CounterTotal> totals(r.counterNames.size());
+    for (size_t s = 0; s < totals.size(); s++) totals[s].name = r.counterNames[s];
+    for (const auto& buffer : r.buffers) {
+        for (size_t s = 0; s < buffer->counts.size(); s++) totals[s].value += buffer->counts[s];
+    }
+    totals.erase(std::remove_if(totals.begin(), totals.end(), [](const CounterTotal& c) { return c.value == 0; }),
+                 totals.end());
+    return totals;
+}
+
+// Eventos "X" (duración completa) en microsegundos; un tid por buffer de hilo
+void writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("trace: cannot write " + path);
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (auto& buffer : r.buffers) {
+        for (const Event& e : buffer->events) {
+            out << (first ? "" : ",\n") << "{\"name\":";
+            writeEscaped(out, r.phaseNames[e.slot]);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << e.startNs / 1000.0 << ",\"dur\":" << e.durationNs / 1000.0;
+            out << "}";
+            first = false;
+        }
+        buffer->events.clear();
+    }
+    out << "\n]}\n";
+    if (!out) throw std::runtime_error("trace: cannot write " + path);
+}
+
+}
@@ -0,0 +1,94 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+// Instrumentación por fases de los planners. Con la opción ENABLE_TRACING de CMake
+// (define RSP_TRACING) las macros miden bloques y acumulan contadores por hilo; sin
+// ella no generan código.
+//
+//   TRACE_SCOPE("fase")            duración del bloque
+//   TRACE_SCOPE_DYNAMIC(nombre)    nombre decidido en ejecución (fuera del camino caliente)
+//   TRACE_COUNT("contador", n)     suma n
+//
+// Cada sitio resuelve su slot una sola vez (variable estática), así que el costo por
+// evento es leer el reloj y sumar en el buffer del hilo. Los eventos individuales sólo
+// se guardan con setRecording(true), para exportarlos en formato Chrome trace
+// (chrome://tracing o Perfetto).
+namespace trace {
+
+struct PhaseTotal {
+    std::string name;
+    uint64_t calls = 0;
+    double totalMs = 0.0;  // suma sobre todos los hilos
+};
+
+struct CounterTotal {
+    std::string name;
+    uint64_t value = 0;
+};
+
+constexpr bool compiledIn() {
+#ifdef RSP_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Crea el registro de buffers si todavía no existe. Un estático que pueda usarlo al
+// destruirse (el pool de TaskScheduler) la llama antes de construirse para que el
+// registro se destruya después que él.
+void initialize();
+void setRecording(bool on);
+
+// Estas cuatro leen o vacían los buffers de todos los hilos, que sus dueños escriben
+// sin lock: llamarlas sólo con el TaskScheduler ocioso y ningún otro hilo midiendo
+// (entre corridas de planners, no durante una).
+void resetTotals();  // los eventos guardados se conservan hasta writeChromeTrace
+std::vector<PhaseTotal> phases();  // fases con al menos una llamada desde resetTotals
+std::vector<CounterTotal> counters();
+// Lanza std::runtime_error si no puede escribir path
+void writeChromeTrace(const std::string& path);
+
+int phaseSlot(const char* name);
+int counterSlot(const char* name);
+void addCount(int slot, uint64_t n);
+
+class Scope {
+public:
+    explicit Scope(int slot) : slot(slot), start(std::chrono::steady_clock::now()) {}
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    int slot;
+    std::chrono::steady_clock::time_point start;
+};
+
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef RSP_TRACING
+#define TRACE_SCOPE(name)                                                         \
+    static const int TRACE_CONCAT(traceSlot_, __LINE__) = trace::phaseSlot(name); \
+    trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(TRACE_CONCAT(traceSlot_, __LINE__))
+#define TRACE_SCOPE_DYNAMIC(name) trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(trace::phaseSlot(name))
+#define TRACE_COUNT(name, n)                                        \
+    do {                                                            \
+        static const int traceCounterSlot = trace::counterSlot(name); \
+        trace::addCount(traceCounterSlot, (n));                     \
+    } while (0)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_DYNAMIC(name) ((void)0)
+#define TRACE_COUNT(name, n) ((void)0)
+#endif
+
+#endif
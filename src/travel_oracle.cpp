@@ -0,0 +1,76 @@
+#include "travel_oracle.hpp"
+#include <fstream>
+#include <stdexcept>
+
+int TravelTable::nearest(double px, double py) const {
+    int best = -1;
+    double bestDistance = 0;
+    for (size_t i = 0; i < size(); i++) {
+        double dx = x[i] - px, dy = y[i] - py;
+        double d = dx * dx + dy * dy;
+        if (best < 0 || d < bestDistance) {
+            best = static_cast<int>(i);
+            bestDistance = d;
+        }
+    }
+    return best;
+}
+
+void TravelTable::closeShortestPaths() {
+    const size_t n = size();
+    repaired = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (time[i * n + i] != 0.0) repaired++;
+        time[i * n + i] = 0.0;
+    }
+    for (size_t k = 0; k < n; k++) {
+        const double* via = &time[k * n];
+        for (size_t i = 0; i < n; i++) {
+            double* row = &time[i * n];
+            const double toVia = row[k];
+            for (size_t j = 0; j < n; j++) {
+                if (toVia + via[j] < row[j]) {
+                    row[j] = toVia + via[j];
+                    repaired++;
+                }
+            }
+        }
+    }
+}
+
+std::shared_ptr<const TravelTable> loadTravelTable(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("loadTravelTable: cannot open " + path);
+
+    long long n = 0;
+    if (!(in >> n) || n <= 0) throw std::runtime_error("loadTravelTable: bad point count in " + path);
+
+    auto table = std::make_shared<TravelTable>();
+    table->x.resize(n);
+    table->y.resize(n);
+    for (long long i = 0; i < n; i++) {
+        if (!(in >> table->x[i] >> table->y[i])) throw std::runtime_error("loadTravelTable: truncated points in " + path);
+    }
+    table->time.resize(static_cast<size_t>(n) * n);
+    for (double& t : table->time) {
+        if (!(in >> t) || t < 0) throw std::runtime_error("loadTravelTable: truncated or negative times in " + path);
+    }
+    table->closeShortestPaths();
+    return table;
+}
+
+TravelOracle::TravelOracle(TravelMetric metric, std::shared_ptr<const TravelTable> table)
+    : kind(metric), table(std::move(table)) {
+    if (kind == TravelMetric::Table && (!this->table || this->table->size() == 0)) {
+        throw std::invalid_argument("TravelOracle: table metric needs a non-empty travel table");
+    }
+}
+
+const char* TravelOracle::name() const {
+    switch (kind) {
+        case TravelMetric::Euclidean: return "euclidean";
+        case TravelMetric::Manhattan: return "manhattan";
+        case TravelMetric::Table:     return "table";
+    }
+    return "unknown";
+}
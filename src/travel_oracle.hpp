@@ -0,0 +1,70 @@
+#ifndef TRAVEL_ORACLE_HPP
+#define TRAVEL_ORACLE_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cmath>
+#include <cstddef>
+#include "geometry.hpp"
+
+enum class TravelMetric { Euclidean, Manhattan, Table };
+
+// Tiempos de viaje precalculados entre n puntos (p.ej. caminos mínimos de una red
+// vial), en una matriz densa por filas. Puede ser asimétrica, pero debe cumplir la
+// desigualdad triangular: la matriz de pares, la poda Apriori y las cotas del índice
+// temporal suponen que quitar un request de una ruta nunca la alarga.
+struct TravelTable {
+    std::vector<double> x, y;
+    std::vector<double> time;  // time[i * size() + j]: de i a j
+    size_t repaired = 0;       // tiempos que acortó closeShortestPaths (0 = ya era métrica)
+
+    size_t size() const { return x.size(); }
+    double at(int from, int to) const { return time[static_cast<size_t>(from) * size() + to]; }
+    int nearest(double px, double py) const;  // -1 si la tabla está vacía
+
+    // Diagonal en 0 y cierre por caminos mínimos (Floyd-Warshall, O(n^3)): cada tiempo
+    // pasa a ser el menor entre ir directo o pasar por otros puntos. Deja la tabla
+    // métrica y cuenta en repaired los acortamientos.
+    void closeShortestPaths();
+};
+
+// Formato de texto: n, luego n líneas "x y", luego n filas de n tiempos. La tabla
+// leída se cierra con closeShortestPaths, así que un archivo que viola la desigualdad
+// triangular se carga con repaired > 0 en vez de invalidar las podas.
+// Lanza std::runtime_error si el archivo no existe o está mal formado.
+std::shared_ptr<const TravelTable> loadTravelTable(const std::string& path);
+
+// Tiempo de viaje entre puntos según la métrica elegida. Con una tabla, cada punto
+// se ajusta al punto de la tabla más cercano; el catálogo guarda esos ajustes para
+// que cada consulta sea una lectura de la matriz.
+class TravelOracle {
+public:
+    TravelOracle() = default;
+    explicit TravelOracle(TravelMetric metric, std::shared_ptr<const TravelTable> table = nullptr);
+
+    TravelMetric metric() const { return kind; }
+    const char* name() const;
+
+    // Nunca menor que la distancia euclídea: las grillas pueden podar por radio
+    bool boundedByEuclidean() const { return kind != TravelMetric::Table; }
+
+    // Punto de la tabla asociado a (x, y); -1 sin tabla
+    int snap(double x, double y) const { return table ? table->nearest(x, y) : -1; }
+
+    double between(double x1, double y1, double x2, double y2) const {
+        switch (kind) {
+            case TravelMetric::Manhattan: return std::abs(x1 - x2) + std::abs(y1 - y2);
+            case TravelMetric::Table:     return table->at(snap(x1, y1), snap(x2, y2));
+            default:                      return planarDistance(x1 - x2, y1 - y2);
+        }
+    }
+
+    double betweenNodes(int from, int to) const { return table->at(from, to); }
+
+private:
+    TravelMetric kind = TravelMetric::Euclidean;
+    std::shared_ptr<const TravelTable> table;
+};
+
+#endif
@@ -4,38 +4,132 @@
 #include <cmath>
 #include <utility>
 #include <random>
+#include <vector>
+#include <algorithm>
+#include "request.hpp"
+#include "vehicle.hpp"
+#include "request_catalog.hpp"
+#include "geometry.hpp"
 
 inline double euclideanDistance(const std::pair<double, double>& a,
                                 const std::pair<double, double>& b) {
-    return std::hypot(a.first - b.first, a.second - b.second);
+    return planarDistance(a.first - b.first, a.second - b.second);
 }
 
-inline double calculateMinSlack(const Vehicle& v, const std::vector<Request>& group) {
-    double currentTime = 0;
-    auto lastLoc = v.location;
-    double minSlack = 1e9;
+inline double tripLength(const RequestCatalog& catalog, int r) {
+    return catalog.tripTime[r];
+}
+
+// Cota para el par (a, b) atendido en ese orden: a no termina antes de
+// releaseTime_a + viaje_a. Suma en el mismo orden que calculateMinSlack, por lo que
+// nunca es mayor que el tiempo simulado; b es alcanzable sólo si el resultado
+// deja slack >= 1.
+inline bool pairBoundHolds(const RequestCatalog& catalog, int a, int b) {
+    double arrival = catalog.releaseTime[a] + tripLength(catalog, a);
+    arrival += catalog.legTime(a, b);
+    arrival += tripLength(catalog, b);
+    return catalog.deadline[b] - arrival >= 1.0;
+}
+
+// Igual que pairBoundHolds pero para cualquier orden de paradas de los dos requests
+// (rutas optimizadas): arranca en el primer origen en su releaseTime y prueba los
+// tres órdenes posibles desde cada request. Simétrica.
+inline bool pairBoundHoldsAnyOrder(const RequestCatalog& catalog, int a, int b) {
+    auto startingWith = [&](int x, int y) {
+        if (pairBoundHolds(catalog, x, y)) return true;  // x+ x- y+ y-
+
+        double atY = catalog.releaseTime[x] + catalog.stopTime(2 * x, 2 * y);
+        if (atY < catalog.releaseTime[y]) atY = catalog.releaseTime[y];
+
+        double t = atY + catalog.stopTime(2 * y, 2 * x + 1);  // x+ y+ x- y-
+        if (catalog.deadline[x] - t >= 1.0) {
+            t += catalog.stopTime(2 * x + 1, 2 * y + 1);
+            if (catalog.deadline[y] - t >= 1.0) return true;
+        }
 
-    for (const auto& r : group) {
-        currentTime += euclideanDistance(lastLoc, r.origin);
-        if (currentTime < r.releaseTime) {
-            currentTime = r.releaseTime;
+        t = atY + tripLength(catalog, y);  // x+ y+ y- x-
+        if (catalog.deadline[y] - t >= 1.0) {
+            t += catalog.stopTime(2 * y + 1, 2 * x + 1);
+            if (catalog.deadline[x] - t >= 1.0) return true;
         }
+        return false;
+    };
+    return startingWith(a, b) || startingWith(b, a);
+}
+
+// Estado de la ruta secuencial después de atender un prefijo del grupo
+struct RouteState {
+    double time = 0;
+    double x = 0, y = 0;  // posición inicial del vehículo
+    int node = -1;        // punto de la tabla de (x, y), si la métrica usa tabla
+    int last = -1;        // último request atendido (-1 = ninguno)
+};
+
+inline RouteState startRoute(const RequestCatalog& catalog, const Vehicle& v) {
+    return {0, v.location.first, v.location.second, catalog.travel.snap(v.location.first, v.location.second), -1};
+}
+
+// Atiende r a continuación (recoger y dejar); devuelve el slack de r
+inline double appendToRoute(RouteState& route, const RequestCatalog& catalog, int r) {
+    route.time += route.last < 0 ? catalog.timeFrom(route.x, route.y, route.node, r) : catalog.legTime(route.last, r);
+    if (route.time < catalog.releaseTime[r]) {
+        route.time = catalog.releaseTime[r];
+    }
 
-        currentTime += euclideanDistance(r.origin, r.destination);
+    route.time += tripLength(catalog, r);
 
-        double slack = r.deadline - currentTime;
+    route.last = r;
+    return catalog.deadline[r] - route.time;
+}
+
+// Simula la ruta del vehículo atendiendo los requests (índices del catálogo) en orden
+inline double calculateMinSlack(const Vehicle& v, const RequestCatalog& catalog, const int* indices, int count) {
+    RouteState route = startRoute(catalog, v);
+    double minSlack = 1e9;
+
+    for (int k = 0; k < count; k++) {
+        double slack = appendToRoute(route, catalog, indices[k]);
         if (slack < 0) return -1; //violación de tiempo
         minSlack = std::min(minSlack, slack);
-
-        lastLoc = r.destination;
     }
 
     return minSlack;
 }
+
+inline double calculateMinSlack(const Vehicle& v, const RequestCatalog& catalog, const std::vector<int>& indices) {
+    return calculateMinSlack(v, catalog, indices.data(), static_cast<int>(indices.size()));
+}
+
+// Percentil q (0..1) con interpolación lineal entre muestras; 0 si no hay ninguna
+inline double percentile(std::vector<double> values, double q) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    double pos = std::clamp(q, 0.0, 1.0) * (values.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = std::min(lo + 1, values.size() - 1);
+    return values[lo] + (pos - lo) * (values[hi] - values[lo]);
+}
+
+inline double mean(const std::vector<double>& values) {
+    if (values.empty()) return 0.0;
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    return sum / values.size();
+}
+
+// Desviación estándar muestral (n - 1); 0 con menos de dos muestras
+inline double sampleStddev(const std::vector<double>& values) {
+    if (values.size() < 2) return 0.0;
+    double m = mean(values), sum = 0.0;
+    for (double v : values) sum += (v - m) * (v - m);
+    return std::sqrt(sum / (values.size() - 1));
+}
+
 //? generacion de requests aleatoria para testear
-inline std::vector<Request> generateRandomRequests(int n, int maxCoord = 50, int maxTime = 100, int maxPayment = 10) {
+inline std::vector<Request> generateRandomRequests(int n, int maxCoord = 50, int maxTime = 100, int maxPayment = 10,
+                                                   unsigned seed = 42) {
     std::vector<Request> requests;
-    std::mt19937 rng(42);  // semilla fija para reproducibilidad
+    std::mt19937 rng(seed);  // misma semilla, mismos requests
     std::uniform_int_distribution<int> coordDist(0, maxCoord);
     std::uniform_int_distribution<int> releaseDist(0, maxTime / 2);
     std::uniform_int_distribution<int> slackDist(10, 40);
@@ -54,9 +148,9 @@ inline std::vector<Request> generateRandomRequests(int n, int maxCoord = 50, int
     return requests;
 }
 
-inline std::vector<Vehicle> generateVehicles(int m, int capacity = 3, int maxCoord = 10) {
+inline std::vector<Vehicle> generateVehicles(int m, int capacity = 3, int maxCoord = 10, unsigned seed = 7) {
     std::vector<Vehicle> vehicles;
-    std::mt19937 rng(7);
+    std::mt19937 rng(seed);
     std::uniform_int_distribution<int> coordDist(0, maxCoord);
 
     for (int i = 1; i <= m; ++i) {
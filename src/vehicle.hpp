@@ -3,13 +3,36 @@
 
 #include <utility>
 #include <vector>
+#include <string>
+#include <stdexcept>
 #include "request.hpp"
 
+// Capacidad máxima soportada: los planners con árbol no generan grupos más grandes
+constexpr int MAX_VEHICLE_CAPACITY = 8;
+
+// Una parada de la ruta asignada: recoger o dejar un request
+struct RouteStop {
+    int requestId;
+    bool pickup;
+};
+
 struct Vehicle {
     int id;
     std::pair<double, double> location;
     int capacity;
-    std::vector<int> assignedRequestIds;
+    std::vector<int> assignedRequestIds{};
+    std::vector<RouteStop> route{};  // orden de paradas elegido por el planner
 };
 
+// Rechaza capacidades negativas o mayores a MAX_VEHICLE_CAPACITY en vez de recortarlas
+inline void validateVehicles(const std::vector<Vehicle>& vehicles, const std::string& what) {
+    for (const auto& v : vehicles) {
+        if (v.capacity < 0 || v.capacity > MAX_VEHICLE_CAPACITY) {
+            throw std::invalid_argument(what + ": vehicle " + std::to_string(v.id) + " has capacity " +
+                                        std::to_string(v.capacity) + " (supported: 0.." +
+                                        std::to_string(MAX_VEHICLE_CAPACITY) + ")");
+        }
+    }
+}
+
 #endif